@@ -0,0 +1,135 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// Measures how long Poller::poll takes, with one ready socket, as the number
+// of registered sockets grows.  The backend is chosen at compile time:
+// zmq_poller when built against a draft libzmq with ZMQ_BUILD_DRAFT_API,
+// zmq_poll otherwise.
+//
+// One PUSH socket is connected to every registered PULL socket.  PUSH
+// deals messages out round-robin, so each send makes the next PULL socket
+// readable and each poll has exactly one item to dispatch.
+//
+//     poll_latency [polls per socket count]
+
+#include <CpperoMQ/All.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+auto percentile(std::vector<double>& values, const double fraction) -> double
+{
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t pollCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const size_t socketCounts[] = { 10, 100, 1000, 4000 };
+
+    std::printf( "backend: %s, %zu polls per socket count\n\n"
+               , CPPEROMQ_HAS_ZMQ_POLLER ? "zmq_poller" : "zmq_poll"
+               , pollCount );
+    std::printf("%-8s %12s %12s %12s\n", "sockets", "median (us)", "p99 (us)", "mean (us)");
+
+    for (const size_t socketCount : socketCounts)
+    {
+        CpperoMQ::Context context(1, static_cast<int>(socketCount) + 16);
+
+        CpperoMQ::PushSocket sender = context.createPushSocket();
+        std::vector<CpperoMQ::PullSocket> receivers;
+        receivers.reserve(socketCount);
+
+        CpperoMQ::Poller poller;
+        CpperoMQ::IncomingMessage message;
+        size_t receivedCount = 0;
+
+        for (size_t i = 0; i < socketCount; ++i)
+        {
+            receivers.emplace_back(context.createPullSocket());
+            CpperoMQ::PullSocket& receiver = receivers.back();
+
+            const std::string endpoint = "inproc://bench.poll." + std::to_string(i);
+            receiver.bind(endpoint.c_str());
+            sender.connect(endpoint.c_str());
+
+            poller.add(CpperoMQ::isReceiveReady(receiver, [&receiver, &message, &receivedCount]()
+            {
+                receiver.receive(message);
+                ++receivedCount;
+            }));
+        }
+
+        // One pass over every socket first, so that each pipe is attached.
+        for (size_t i = 0; i < socketCount; ++i)
+        {
+            sender.send(CpperoMQ::OutgoingMessage("x"));
+            poller.poll();
+        }
+
+        std::vector<double> times;
+        times.reserve(pollCount);
+
+        for (size_t i = 0; i < pollCount; ++i)
+        {
+            sender.send(CpperoMQ::OutgoingMessage("x"));
+
+            const Clock::time_point start = Clock::now();
+            poller.poll();
+            const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+
+            times.push_back(elapsed.count());
+        }
+
+        if (receivedCount != socketCount + pollCount)
+        {
+            std::fprintf(stderr, "expected one message per poll\n");
+            return 1;
+        }
+
+        double total = 0.0;
+        for (const double time : times)
+        {
+            total += time;
+        }
+
+        const double mean = total / times.size();
+        const double median = percentile(times, 0.5);
+        const double p99 = percentile(times, 0.99);
+        std::printf("%-8zu %12.2f %12.2f %12.2f\n", socketCount, median, p99, mean);
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// Compares the throughput of ProxyEngine, with no hooks, against libzmq's
+// own proxy (Proxy::run).  Messages flow one way, from a DEALER through the
+// Router/Dealer proxy to another DEALER, over inproc and over tcp.
+//
+//     proxy_throughput [message count]
+
+#include <CpperoMQ/All.hpp>
+#include <CpperoMQ/ProxyEngine.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+const size_t FrameSize = 64;
+const int RunCount = 7;
+
+enum class Implementation { LibzmqProxy, Engine };
+
+auto bindEndpoint(CpperoMQ::Socket& socket, const std::string& endpoint) -> std::string
+{
+    socket.bind(endpoint.c_str());
+
+    // Resolves the port of a tcp wildcard bind.
+    char buffer[256];
+    socket.getLastEndpoint(sizeof(buffer), buffer);
+    return buffer;
+}
+
+// Returns the messages per second seen by the receiving end.
+auto measure( const Implementation implementation
+            , const char* const transport
+            , const size_t frameCount
+            , const size_t messageCount ) -> double
+{
+    CpperoMQ::Context context;
+
+    CpperoMQ::RouterSocket frontend = context.createRouterSocket();
+    CpperoMQ::DealerSocket backend  = context.createDealerSocket();
+    CpperoMQ::DealerSocket sender   = context.createDealerSocket();
+    CpperoMQ::DealerSocket receiver = context.createDealerSocket();
+    CpperoMQ::PullSocket control    = context.createPullSocket();
+    CpperoMQ::PushSocket controller = context.createPushSocket();
+
+    const bool isTcp = (std::string("tcp") == transport);
+    sender.connect(bindEndpoint(frontend, isTcp ? "tcp://127.0.0.1:*" : "inproc://bench.frontend").c_str());
+    receiver.connect(bindEndpoint(backend, isTcp ? "tcp://127.0.0.1:*" : "inproc://bench.backend").c_str());
+    control.bind("inproc://bench.control");
+    controller.connect("inproc://bench.control");
+
+    CpperoMQ::ProxyEngine<CpperoMQ::RouterSocket, CpperoMQ::DealerSocket> engine(frontend, backend);
+    CpperoMQ::Proxy proxy;
+    proxy.setControlSocket(control);
+
+    std::thread proxyThread;
+    if (Implementation::Engine == implementation)
+    {
+        proxyThread = std::thread([&]() { engine.run(); });
+    }
+    else
+    {
+        proxyThread = std::thread([&]() { proxy.run(frontend, backend); });
+    }
+
+    const std::vector<char> payload(FrameSize, 'x');
+    std::vector<CpperoMQ::OutgoingMessage> frames;
+    const auto sendMessage = [&]()
+    {
+        frames.clear();
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            frames.emplace_back(FrameSize, payload.data());
+        }
+
+        sender.send( std::make_move_iterator(frames.begin())
+                   , std::make_move_iterator(frames.end()) );
+    };
+
+    // One round trip first, so that connecting is not timed.
+    CpperoMQ::MultipartMessage message;
+    sendMessage();
+    receiver.receive(message);
+
+    Clock::time_point end;
+    std::thread receiverThread([&]()
+    {
+        CpperoMQ::MultipartMessage received;
+        for (size_t i = 0; i < messageCount; ++i)
+        {
+            receiver.receive(received);
+        }
+
+        end = Clock::now();
+    });
+
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < messageCount; ++i)
+    {
+        sendMessage();
+    }
+
+    receiverThread.join();
+
+    if (Implementation::Engine == implementation)
+    {
+        engine.stop();
+    }
+    else
+    {
+        controller.send(CpperoMQ::OutgoingMessage("TERMINATE"));
+    }
+
+    proxyThread.join();
+
+    const std::chrono::duration<double> elapsed = end - start;
+    return (messageCount / elapsed.count());
+}
+
+auto median(std::vector<double> values) -> double
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t messageCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::printf("%zu messages of %zu-byte frames, median of %d runs\n\n", messageCount, FrameSize, RunCount);
+    std::printf("%-9s %-7s %16s %17s %8s\n", "transport", "frames", "zmq_proxy msg/s", "ProxyEngine msg/s", "ratio");
+
+    const char* const transports[] = { "inproc", "tcp" };
+    const size_t frameCounts[] = { 1, 4 };
+
+    for (const char* const transport : transports)
+    {
+        for (const size_t frameCount : frameCounts)
+        {
+            // Interleaved, so that drift in the machine's load affects both.
+            std::vector<double> libzmqRates;
+            std::vector<double> engineRates;
+            for (int run = 0; run < RunCount; ++run)
+            {
+                libzmqRates.push_back(measure(Implementation::LibzmqProxy, transport, frameCount, messageCount));
+                engineRates.push_back(measure(Implementation::Engine, transport, frameCount, messageCount));
+            }
+
+            const double libzmqRate = median(libzmqRates);
+            const double engineRate = median(engineRates);
+            std::printf( "%-9s %-7zu %16.0f %17.0f %8.3f\n"
+                       , transport
+                       , frameCount
+                       , libzmqRate
+                       , engineRate
+                       , engineRate / libzmqRate );
+        }
+    }
+
+    return 0;
+}
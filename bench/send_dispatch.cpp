@@ -0,0 +1,183 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// Measures what a part costs to send depending on how it is dispatched: a
+// Sendable through a base class reference (virtual), a final Sendable and a
+// StaticSendable (both resolved at compile time), and raw zmq_msg_send.
+// Every variant builds and sends the same 8-byte frame, to a PUB socket
+// without subscribers so that libzmq does as little as possible and the
+// difference is the dispatch.
+//
+//     send_dispatch [send count]
+
+#include <CpperoMQ/All.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+const int RunCount = 7;
+
+auto sendCounter(const CpperoMQ::Socket& socket, const bool moreToSend, const uint64_t counter) -> bool
+{
+    zmq_msg_t message;
+    zmq_msg_init_size(&message, sizeof(counter));
+    std::memcpy(zmq_msg_data(&message), &counter, sizeof(counter));
+
+    void* const handle = static_cast<void*>(const_cast<CpperoMQ::Socket&>(socket));
+    if (zmq_msg_send(&message, handle, (moreToSend) ? ZMQ_SNDMORE : 0) < 0)
+    {
+        zmq_msg_close(&message);
+        throw CpperoMQ::Error();
+    }
+
+    return true;
+}
+
+class VirtualCounter : public CpperoMQ::Sendable
+{
+public:
+    virtual auto send(const CpperoMQ::Socket& socket, const bool moreToSend) const -> bool override
+    {
+        return (sendCounter(socket, moreToSend, mCounter++));
+    }
+
+private:
+    mutable uint64_t mCounter = 0;
+};
+
+class FinalCounter final : public CpperoMQ::Sendable
+{
+public:
+    virtual auto send(const CpperoMQ::Socket& socket, const bool moreToSend) const -> bool override
+    {
+        return (sendCounter(socket, moreToSend, mCounter++));
+    }
+
+private:
+    mutable uint64_t mCounter = 0;
+};
+
+class StaticCounter : public CpperoMQ::StaticSendable<StaticCounter>
+{
+public:
+    auto send(const CpperoMQ::Socket& socket, const bool moreToSend) const -> bool
+    {
+        return (sendCounter(socket, moreToSend, mCounter++));
+    }
+
+private:
+    mutable uint64_t mCounter = 0;
+};
+
+// Returns nanoseconds per send.
+template <typename Send>
+auto measure(const size_t sendCount, Send&& send) -> double
+{
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < sendCount; ++i)
+    {
+        send();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return (elapsed.count() / sendCount);
+}
+
+auto median(std::vector<double> values) -> double
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t sendCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+
+    CpperoMQ::Context context;
+    CpperoMQ::PublishSocket socket = context.createPublishSocket();
+    socket.bind("inproc://bench.dispatch");
+    void* const handle = static_cast<void*>(socket);
+
+    VirtualCounter virtualCounter;
+    FinalCounter finalCounter;
+    StaticCounter staticCounter;
+    uint64_t rawCounter = 0;
+
+    // Read through a volatile pointer, so that the compiler cannot see the
+    // dynamic type and devirtualize the call.
+    const CpperoMQ::Sendable* volatile sendable = &virtualCounter;
+
+    std::vector<double> rawTimes;
+    std::vector<double> virtualTimes;
+    std::vector<double> finalTimes;
+    std::vector<double> staticTimes;
+
+    // Interleaved, so that drift in the machine's load affects all of them.
+    for (int run = 0; run < RunCount; ++run)
+    {
+        rawTimes.push_back(measure(sendCount, [&]()
+        {
+            const uint64_t counter = rawCounter++;
+
+            zmq_msg_t message;
+            zmq_msg_init_size(&message, sizeof(counter));
+            std::memcpy(zmq_msg_data(&message), &counter, sizeof(counter));
+            if (zmq_msg_send(&message, handle, 0) < 0)
+            {
+                zmq_msg_close(&message);
+            }
+        }));
+
+        virtualTimes.push_back(measure(sendCount, [&]() { socket.send(*sendable); }));
+        finalTimes.push_back(measure(sendCount, [&]() { socket.send(finalCounter); }));
+        staticTimes.push_back(measure(sendCount, [&]() { socket.send(staticCounter); }));
+    }
+
+    const double rawTime = median(rawTimes);
+
+    std::printf("%zu sends of an 8-byte frame, median of %d runs\n\n", sendCount, RunCount);
+    std::printf("%-20s %10s %12s\n", "dispatch", "ns/send", "vs raw (ns)");
+
+    const auto report = [&](const char* const name, const double time)
+    {
+        std::printf("%-20s %10.1f %+12.1f\n", name, time, time - rawTime);
+    };
+
+    report("raw zmq_msg_send", rawTime);
+    report("virtual Sendable", median(virtualTimes));
+    report("final Sendable", median(finalTimes));
+    report("StaticSendable", median(staticTimes));
+
+    return 0;
+}
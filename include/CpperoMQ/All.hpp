@@ -22,28 +22,45 @@
 
 #pragma once
 
+#include <CpperoMQ/AsyncClient.hpp>
+#include <CpperoMQ/AsyncServer.hpp>
+#include <CpperoMQ/Awaitable.hpp>
+#include <CpperoMQ/BufferReceiver.hpp>
 #include <CpperoMQ/Common.hpp>
 #include <CpperoMQ/Context.hpp>
 #include <CpperoMQ/DealerSocket.hpp>
+#include <CpperoMQ/EdgeTriggeredAdapter.hpp>
 #include <CpperoMQ/Error.hpp>
 #include <CpperoMQ/ExtendedPublishSocket.hpp>
 #include <CpperoMQ/ExtendedSubscribeSocket.hpp>
 #include <CpperoMQ/IncomingMessage.hpp>
+#include <CpperoMQ/MappedFile.hpp>
 #include <CpperoMQ/Message.hpp>
+#include <CpperoMQ/MessagePool.hpp>
+#include <CpperoMQ/MultipartMessage.hpp>
 #include <CpperoMQ/OutgoingMessage.hpp>
 #include <CpperoMQ/Poller.hpp>
 #include <CpperoMQ/PollItem.hpp>
 #include <CpperoMQ/Proxy.hpp>
+#include <CpperoMQ/ProxyEngine.hpp>
 #include <CpperoMQ/PublishSocket.hpp>
 #include <CpperoMQ/PullSocket.hpp>
 #include <CpperoMQ/PushSocket.hpp>
 #include <CpperoMQ/Receivable.hpp>
 #include <CpperoMQ/ReplySocket.hpp>
 #include <CpperoMQ/RequestSocket.hpp>
+#include <CpperoMQ/Result.hpp>
 #include <CpperoMQ/RouterSocket.hpp>
+#include <CpperoMQ/Schema.hpp>
+#include <CpperoMQ/Scheduler.hpp>
 #include <CpperoMQ/Sendable.hpp>
+#include <CpperoMQ/SharedMessage.hpp>
 #include <CpperoMQ/Socket.hpp>
+#include <CpperoMQ/Span.hpp>
+#include <CpperoMQ/StaticReceivable.hpp>
+#include <CpperoMQ/StaticSendable.hpp>
 #include <CpperoMQ/SubscribeSocket.hpp>
+#include <CpperoMQ/TimerWheel.hpp>
 #include <CpperoMQ/Version.hpp>
 #include <CpperoMQ/Mixins/ConflatingSocket.hpp>
 #include <CpperoMQ/Mixins/IdentifyingSocket.hpp>
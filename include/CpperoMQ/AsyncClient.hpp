@@ -0,0 +1,640 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Awaitable.hpp>
+#include <CpperoMQ/DealerSocket.hpp>
+#include <CpperoMQ/Error.hpp>
+#include <CpperoMQ/MultipartMessage.hpp>
+#include <CpperoMQ/OutgoingMessage.hpp>
+#include <CpperoMQ/Result.hpp>
+#include <CpperoMQ/TimerWheel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+// Pipelines requests over one DealerSocket.  Each request is sent as
+// [correlation id, empty delimiter, parts...] and the server is expected to
+// echo the first two frames back ahead of its reply, which may carry any
+// number of frames but at least one.  Any number of requests can be
+// outstanding; replies complete them in whatever order they arrive.
+//
+// Replies are only read by processReplies, to be called whenever the socket
+// is readable (e.g. from a Poller callback), and by coroutines awaiting
+// asyncRequest.  Request timeouts are timers on 'timerWheel', which must be
+// advanced by the same thread, typically by being the Poller's or
+// Scheduler's own TimerWheel.  A reply that arrives after its request timed
+// out is discarded.  Requests still pending when the client is destroyed
+// complete with ECANCELED.
+class AsyncClient final
+{
+public:
+    using CorrelationId = uint64_t;
+
+    // 'result' is successful, or ETIMEDOUT or ECANCELED with an empty
+    // 'reply'.  'reply' holds the frames after the delimiter and may be moved
+    // from.
+    using Callback = std::function<void(const Result& result, MultipartMessage& reply)>;
+
+    AsyncClient(DealerSocket& socket, TimerWheel& timerWheel);
+    ~AsyncClient();
+    AsyncClient(const AsyncClient& other) = delete;
+    AsyncClient(AsyncClient&& other) = delete;
+    AsyncClient& operator=(const AsyncClient& other) = delete;
+    AsyncClient& operator=(AsyncClient&& other) = delete;
+
+    // Sends a request and calls 'callback' once it is answered or has timed
+    // out.  A 'timeout' of zero or less never times out.  The request is sent
+    // with ZMQ_DONTWAIT, which user-defined parts must accept.  Returns 0,
+    // without calling 'callback', if the request could not be queued without
+    // blocking.
+    template <typename... SendableTypes>
+    auto request( const std::chrono::milliseconds timeout
+                , Callback callback
+                , SendableTypes&&... sendables ) -> CorrelationId;
+
+    // As request, but completes a future instead.  A timeout or a request
+    // that could not be queued sets an Error with ETIMEDOUT or EAGAIN.
+    template <typename... SendableTypes>
+    auto requestFuture( const std::chrono::milliseconds timeout
+                      , SendableTypes&&... sendables ) -> std::future<MultipartMessage>;
+
+#if CPPEROMQ_HAS_COROUTINES
+    template <typename... SendableTypes>
+    class RequestAwaitable;
+
+    // As requestFuture, but for a coroutine run by a Scheduler: co_await
+    // yields the reply or throws the Error.  A request that cannot be queued
+    // yet suspends the coroutine until the socket is writable.  While
+    // coroutines are waiting, the client keeps a reader parked on the socket,
+    // so nothing else needs to call processReplies.  Suspending outside a
+    // running Scheduler throws Error(EFAULT).
+    template <typename... SendableTypes>
+    auto asyncRequest( const std::chrono::milliseconds timeout
+                     , SendableTypes&&... sendables ) -> RequestAwaitable<SendableTypes...>;
+#endif
+
+    // Receives every reply that is already queued, without blocking, and
+    // completes the matching requests.  Returns the number of replies
+    // received, including discarded ones.
+    auto processReplies() -> size_t;
+
+    // Forgets a request without calling its callback.  Returns false if it
+    // has already completed.
+    auto cancel(const CorrelationId correlationId) -> bool;
+
+    auto getPendingCount() const -> size_t;
+    auto getSocket() -> DealerSocket&;
+
+private:
+    struct PendingRequest
+    {
+        Callback callback;
+        TimerWheel::TimerId timerId;
+        bool hasTimer;
+    };
+
+#if CPPEROMQ_HAS_COROUTINES
+    class ReplyReader final : public AsyncOperation
+    {
+    public:
+        explicit ReplyReader(AsyncClient& client);
+
+        virtual auto tryComplete() -> bool override;
+
+    private:
+        AsyncClient& mClient;
+    };
+
+    // A coroutine's request, parked until the socket is writable.
+    class BlockedRequest : public AsyncOperation
+    {
+    public:
+        // Unparks the request and resumes its coroutine with ECANCELED.
+        virtual auto abandon() -> void = 0;
+
+    protected:
+        ~BlockedRequest() = default;
+    };
+
+    auto beginAwait(AsyncContext& context) -> void;
+    auto endAwait() -> void;
+    auto unblock(BlockedRequest& request) -> void;
+#endif
+
+    auto complete( const CorrelationId correlationId
+                 , const Result& result
+                 , MultipartMessage& reply ) -> void;
+
+    DealerSocket& mSocket;
+    TimerWheel& mTimerWheel;
+    std::unordered_map<CorrelationId, PendingRequest> mPendingRequests;
+    CorrelationId mNextCorrelationId;
+
+    // Reused by processReplies.
+    IncomingMessage mCorrelationFrame;
+    IncomingMessage mDelimiter;
+    MultipartMessage mReply;
+
+#if CPPEROMQ_HAS_COROUTINES
+    ReplyReader mReader;
+    AsyncContext* mReaderContext;
+    size_t mAwaitedCount;
+    bool mIsReaderParked;
+    bool mIsReading;
+    std::vector<BlockedRequest*> mBlockedRequests;
+#endif
+};
+
+#if CPPEROMQ_HAS_COROUTINES
+template <typename... SendableTypes>
+class AsyncClient::RequestAwaitable final : public BlockedRequest
+{
+public:
+    template <typename... Parts>
+    RequestAwaitable( AsyncClient& client
+                    , const std::chrono::milliseconds timeout
+                    , Parts&&... parts );
+
+    auto await_ready() const NOEXCEPT -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) -> bool;
+    auto await_resume() -> MultipartMessage;
+
+    virtual auto tryComplete() -> bool override;
+    virtual auto abandon() -> void override;
+
+private:
+    // Returns false if the request could not be queued without blocking.
+    auto trySendRequest() -> bool;
+
+    AsyncClient& mClient;
+    std::chrono::milliseconds mTimeout;
+    std::tuple<SendableTypes...> mSendables;
+    AsyncContext* mContext;
+    std::coroutine_handle<> mAwaitingHandle;
+    Result mResult;
+    MultipartMessage mReply;
+};
+#endif
+
+inline
+AsyncClient::AsyncClient(DealerSocket& socket, TimerWheel& timerWheel)
+    : mSocket(socket)
+    , mTimerWheel(timerWheel)
+    , mPendingRequests()
+    , mNextCorrelationId(1)
+    , mCorrelationFrame()
+    , mDelimiter()
+    , mReply()
+#if CPPEROMQ_HAS_COROUTINES
+    , mReader(*this)
+    , mReaderContext(nullptr)
+    , mAwaitedCount(0)
+    , mIsReaderParked(false)
+    , mIsReading(false)
+    , mBlockedRequests()
+#endif
+{
+}
+
+inline
+AsyncClient::~AsyncClient()
+{
+    // Swapped out first, so that callbacks cannot reach the pending requests.
+    std::unordered_map<CorrelationId, PendingRequest> pendingRequests;
+    pendingRequests.swap(mPendingRequests);
+
+    for (auto& pendingRequest : pendingRequests)
+    {
+        if (pendingRequest.second.hasTimer)
+        {
+            mTimerWheel.cancel(pendingRequest.second.timerId);
+        }
+
+        MultipartMessage emptyReply;
+        pendingRequest.second.callback(Result(ECANCELED), emptyReply);
+    }
+
+#if CPPEROMQ_HAS_COROUTINES
+    while (!mBlockedRequests.empty())
+    {
+        BlockedRequest* blockedRequest = mBlockedRequests.back();
+        mBlockedRequests.pop_back();
+        blockedRequest->abandon();
+    }
+
+    if (mIsReaderParked)
+    {
+        mReaderContext->cancel(mSocket, mReader);
+    }
+#endif
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::request( const std::chrono::milliseconds timeout
+                         , Callback callback
+                         , SendableTypes&&... sendables ) -> CorrelationId
+{
+    const CorrelationId correlationId = mNextCorrelationId;
+
+    const Result result = mSocket.trySend( ZMQ_DONTWAIT
+                                         , OutgoingMessage(sizeof(correlationId), &correlationId)
+                                         , OutgoingMessage()
+                                         , std::forward<SendableTypes>(sendables)... );
+    if (!checkResult(result))
+    {
+        return 0;
+    }
+
+    ++mNextCorrelationId;
+
+    PendingRequest& pendingRequest = mPendingRequests[correlationId];
+    pendingRequest.callback = std::move(callback);
+    pendingRequest.timerId  = 0;
+    pendingRequest.hasTimer = (timeout.count() > 0);
+
+    if (pendingRequest.hasTimer)
+    {
+        pendingRequest.timerId = mTimerWheel.add(timeout, [this, correlationId]()
+        {
+            const auto iterator = mPendingRequests.find(correlationId);
+            if (iterator != mPendingRequests.end())
+            {
+                iterator->second.hasTimer = false;
+
+                MultipartMessage emptyReply;
+                complete(correlationId, Result(ETIMEDOUT), emptyReply);
+            }
+        });
+    }
+
+    return correlationId;
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::requestFuture( const std::chrono::milliseconds timeout
+                               , SendableTypes&&... sendables ) -> std::future<MultipartMessage>
+{
+    // std::function must be copyable, so the promise is shared.
+    auto promise = std::make_shared<std::promise<MultipartMessage>>();
+    std::future<MultipartMessage> future = promise->get_future();
+
+    const auto callback = [promise](const Result& result, MultipartMessage& reply)
+    {
+        if (result.isSuccess())
+        {
+            promise->set_value(std::move(reply));
+        }
+        else
+        {
+            promise->set_exception(std::make_exception_ptr(Error(result.getErrorNumber())));
+        }
+    };
+
+    if (0 == request(timeout, callback, std::forward<SendableTypes>(sendables)...))
+    {
+        promise->set_exception(std::make_exception_ptr(Error(EAGAIN)));
+    }
+
+    return future;
+}
+
+#if CPPEROMQ_HAS_COROUTINES
+template <typename... SendableTypes>
+inline
+auto AsyncClient::asyncRequest( const std::chrono::milliseconds timeout
+                              , SendableTypes&&... sendables ) -> RequestAwaitable<SendableTypes...>
+{
+    return (RequestAwaitable<SendableTypes...>( *this
+                                              , timeout
+                                              , std::forward<SendableTypes>(sendables)... ));
+}
+#endif
+
+inline
+auto AsyncClient::processReplies() -> size_t
+{
+    size_t receivedCount = 0;
+
+    for (;;)
+    {
+        const Result result = mSocket.tryReceive( ZMQ_DONTWAIT
+                                                , mCorrelationFrame
+                                                , mDelimiter
+                                                , mReply );
+        if (result.isAgain())
+        {
+            break;
+        }
+
+        ++receivedCount;
+
+        // Malformed replies (EPROTO) are discarded.
+        if (!checkResult(result) ||
+            mCorrelationFrame.size() != sizeof(CorrelationId) ||
+            mDelimiter.size() != 0)
+        {
+            continue;
+        }
+
+        CorrelationId correlationId;
+        std::memcpy(&correlationId, mCorrelationFrame.data(), sizeof(correlationId));
+        complete(correlationId, Result(), mReply);
+    }
+
+    return receivedCount;
+}
+
+inline
+auto AsyncClient::cancel(const CorrelationId correlationId) -> bool
+{
+    const auto iterator = mPendingRequests.find(correlationId);
+    if (iterator == mPendingRequests.end())
+    {
+        return false;
+    }
+
+    if (iterator->second.hasTimer)
+    {
+        mTimerWheel.cancel(iterator->second.timerId);
+    }
+
+    mPendingRequests.erase(iterator);
+    return true;
+}
+
+inline
+auto AsyncClient::getPendingCount() const -> size_t
+{
+    return mPendingRequests.size();
+}
+
+inline
+auto AsyncClient::getSocket() -> DealerSocket&
+{
+    return mSocket;
+}
+
+inline
+auto AsyncClient::complete( const CorrelationId correlationId
+                          , const Result& result
+                          , MultipartMessage& reply ) -> void
+{
+    const auto iterator = mPendingRequests.find(correlationId);
+    if (iterator == mPendingRequests.end())
+    {
+        return;
+    }
+
+    // Erased first, so that the callback may send further requests.
+    PendingRequest pendingRequest = std::move(iterator->second);
+    mPendingRequests.erase(iterator);
+
+    if (pendingRequest.hasTimer)
+    {
+        mTimerWheel.cancel(pendingRequest.timerId);
+    }
+
+    pendingRequest.callback(result, reply);
+}
+
+#if CPPEROMQ_HAS_COROUTINES
+inline
+auto AsyncClient::beginAwait(AsyncContext& context) -> void
+{
+    ++mAwaitedCount;
+
+    if (!mIsReaderParked)
+    {
+        mReaderContext  = &context;
+        mIsReaderParked = true;
+        context.suspend(mSocket, ZMQ_POLLIN, mReader);
+    }
+}
+
+inline
+auto AsyncClient::endAwait() -> void
+{
+    CPPEROMQ_ASSERT(mAwaitedCount > 0);
+    --mAwaitedCount;
+
+    // While reading, the reader unparks itself by completing.
+    if (0 == mAwaitedCount && mIsReaderParked && !mIsReading)
+    {
+        mIsReaderParked = false;
+        mReaderContext->cancel(mSocket, mReader);
+    }
+}
+
+inline
+auto AsyncClient::unblock(BlockedRequest& request) -> void
+{
+    const auto iterator = std::find(mBlockedRequests.begin(), mBlockedRequests.end(), &request);
+    if (iterator != mBlockedRequests.end())
+    {
+        mBlockedRequests.erase(iterator);
+    }
+}
+
+inline
+AsyncClient::ReplyReader::ReplyReader(AsyncClient& client)
+    : AsyncOperation()
+    , mClient(client)
+{
+}
+
+inline
+auto AsyncClient::ReplyReader::tryComplete() -> bool
+{
+    mClient.mIsReading = true;
+
+    try
+    {
+        mClient.processReplies();
+    }
+    catch (...)
+    {
+        mClient.mIsReading = false;
+        throw;
+    }
+
+    mClient.mIsReading = false;
+
+    // Completing, without a coroutine to resume, unparks the reader.
+    const bool isDone = (0 == mClient.mAwaitedCount);
+    if (isDone)
+    {
+        mClient.mIsReaderParked = false;
+    }
+
+    return isDone;
+}
+
+template <typename... SendableTypes>
+template <typename... Parts>
+inline
+AsyncClient::RequestAwaitable<SendableTypes...>::RequestAwaitable( AsyncClient& client
+                                                                 , const std::chrono::milliseconds timeout
+                                                                 , Parts&&... parts )
+    : BlockedRequest()
+    , mClient(client)
+    , mTimeout(timeout)
+    , mSendables(std::forward<Parts>(parts)...)
+    , mContext(nullptr)
+    , mAwaitingHandle()
+    , mResult()
+    , mReply()
+{
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::RequestAwaitable<SendableTypes...>::await_ready() const NOEXCEPT -> bool
+{
+    return false;
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::RequestAwaitable<SendableTypes...>::await_suspend(std::coroutine_handle<> handle) -> bool
+{
+    mContext = AsyncContext::getCurrent();
+    if (nullptr == mContext)
+    {
+        throw Error(EFAULT);
+    }
+
+    mAwaitingHandle = handle;
+
+    if (trySendRequest())
+    {
+        // Suspended until the reply, unless sending failed outright.
+        return mResult.isSuccess();
+    }
+
+    // Parked without a handle, so sending the request later only unparks it.
+    mClient.mBlockedRequests.push_back(this);
+    mContext->suspend(mClient.mSocket, ZMQ_POLLOUT, *this);
+    return true;
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::RequestAwaitable<SendableTypes...>::await_resume() -> MultipartMessage
+{
+    if (!mResult.isSuccess())
+    {
+        throw Error(mResult.getErrorNumber());
+    }
+
+    return (std::move(mReply));
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::RequestAwaitable<SendableTypes...>::tryComplete() -> bool
+{
+    if (!trySendRequest())
+    {
+        return false;
+    }
+
+    mClient.unblock(*this);
+
+    // A request that could not be sent has no reply to wait for.
+    if (!mResult.isSuccess())
+    {
+        mHandle = mAwaitingHandle;
+    }
+
+    return true;
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::RequestAwaitable<SendableTypes...>::abandon() -> void
+{
+    mContext->cancel(mClient.mSocket, *this);
+    mResult = Result(ECANCELED);
+    mContext->schedule(mAwaitingHandle);
+}
+
+template <typename... SendableTypes>
+inline
+auto AsyncClient::RequestAwaitable<SendableTypes...>::trySendRequest() -> bool
+{
+    const auto callback = [this](const Result& result, MultipartMessage& reply)
+    {
+        mResult = result;
+        if (result.isSuccess())
+        {
+            mReply = std::move(reply);
+        }
+
+        mClient.endAwait();
+        mContext->schedule(mAwaitingHandle);
+    };
+
+    CorrelationId correlationId = 0;
+    try
+    {
+        correlationId = std::apply( [&](auto&... sendables)
+                                    {
+                                        return mClient.request( mTimeout
+                                                              , callback
+                                                              , std::forward<SendableTypes>(sendables)... );
+                                    }
+                                  , mSendables );
+    }
+    catch (const Error& error)
+    {
+        mResult = Result(error.number());
+        return true;
+    }
+
+    if (0 == correlationId)
+    {
+        return false;
+    }
+
+    mClient.beginAwait(*mContext);
+    return true;
+}
+#endif
+
+}
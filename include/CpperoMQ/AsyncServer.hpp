@@ -0,0 +1,523 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Context.hpp>
+#include <CpperoMQ/DealerSocket.hpp>
+#include <CpperoMQ/IncomingMessage.hpp>
+#include <CpperoMQ/MultipartMessage.hpp>
+#include <CpperoMQ/OutgoingMessage.hpp>
+#include <CpperoMQ/Poller.hpp>
+#include <CpperoMQ/Result.hpp>
+#include <CpperoMQ/RouterSocket.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+// Serves requests arriving on a RouterSocket with a pool of worker threads.
+//
+// A request is [envelope..., empty delimiter, body...], where the envelope
+// is however many routing hops precede the delimiter, and the body has
+// at least one frame; other messages are dropped.  The envelope stays on
+// the polling (I/O) thread; only the body is passed, without copying, to an
+// idle worker over inproc.  Workers announce that they are idle, so requests
+// go to the least recently used idle worker and a slow request only ever
+// occupies the worker handling it.  Requests arriving while every worker is
+// busy wait in a queue, and once 'maxPendingRequests' are queued the
+// frontend is not read until one is dispatched.  Replies are routed back
+// under their envelope as they complete, in any order.  A reply the frontend
+// cannot take straight away, because its peer has gone (with
+// ZMQ_ROUTER_MANDATORY) or is at its high-water mark, is dropped and counted.
+//
+// The server does its I/O from callbacks of the Poller it is attached to;
+// the metrics are to be read from the thread polling it.
+class AsyncServer final
+{
+public:
+    // Called on a worker thread with the request body, to append the reply
+    // frames to 'reply' (which starts out empty).  An empty reply is sent as
+    // a single empty frame.  The handler must not throw.
+    using Handler = std::function<void(MultipartMessage& request, std::vector<OutgoingMessage>& reply)>;
+
+    // How often, in milliseconds, an idle worker checks whether to stop.
+    static const int WorkerStopInterval = 100;
+
+    AsyncServer( Context& context
+               , RouterSocket& frontend
+               , const size_t workerCount
+               , Handler handler
+               , const size_t maxPendingRequests = 10000 );
+    ~AsyncServer();
+    AsyncServer(const AsyncServer& other) = delete;
+    AsyncServer(AsyncServer&& other) = delete;
+    AsyncServer& operator=(const AsyncServer& other) = delete;
+    AsyncServer& operator=(AsyncServer&& other) = delete;
+
+    // Registers the frontend and the workers' socket with 'poller', which
+    // must stay alive until detach or destruction of the server.
+    auto attach(Poller& poller) -> void;
+    auto detach() -> void;
+
+    auto getWorkerCount() const     -> size_t;
+    auto getIdleWorkerCount() const -> size_t;
+    auto getPendingCount() const    -> size_t; // queued for a worker
+    auto getInFlightCount() const   -> size_t; // with a worker
+    auto getCompletedCount() const  -> uint64_t;
+    auto getDroppedCount() const    -> uint64_t; // completed, reply not sent
+
+private:
+    using RequestId = uint64_t;
+
+    struct Request
+    {
+        std::vector<OutgoingMessage> envelope;
+        std::vector<OutgoingMessage> body;
+        uint32_t generation;
+    };
+
+    auto processRequests() -> void;
+    auto processReplies()  -> void;
+
+    auto allocateRequest() -> uint32_t;
+    auto releaseRequest(const uint32_t index) -> void;
+    auto dispatch(const uint32_t index) -> void;
+    auto dispatchPending() -> void;
+    auto updateFrontendRegistration() -> void;
+    auto runWorker() -> void;
+
+    static auto makeRequestId(const uint32_t index, const uint32_t generation) -> RequestId;
+
+    Context& mContext;
+    RouterSocket& mFrontend;
+    RouterSocket mBackend;
+    std::string mBackendEndpoint;
+    Handler mHandler;
+    size_t mMaxPendingRequests;
+
+    std::vector<Request> mRequests;
+    std::vector<uint32_t> mFreeRequests;
+    std::deque<uint32_t> mPendingRequests;
+    std::deque<IncomingMessage> mIdleWorkers;
+    size_t mInFlightCount;
+    uint64_t mCompletedCount;
+    uint64_t mDroppedCount;
+
+    // Reused by processRequests and processReplies.
+    MultipartMessage mMessage;
+    IncomingMessage mWorkerIdentity;
+    std::vector<OutgoingMessage> mOutgoing;
+
+    Poller* mPoller;
+    bool mIsFrontendRegistered;
+
+    std::atomic<bool> mIsRunning;
+    std::vector<std::thread> mWorkers;
+};
+
+inline
+AsyncServer::AsyncServer( Context& context
+                        , RouterSocket& frontend
+                        , const size_t workerCount
+                        , Handler handler
+                        , const size_t maxPendingRequests )
+    : mContext(context)
+    , mFrontend(frontend)
+    , mBackend(context.createRouterSocket())
+    , mBackendEndpoint("inproc://CpperoMQ.AsyncServer." + std::to_string(reinterpret_cast<uintptr_t>(this)))
+    , mHandler(std::move(handler))
+    , mMaxPendingRequests(maxPendingRequests)
+    , mRequests()
+    , mFreeRequests()
+    , mPendingRequests()
+    , mIdleWorkers()
+    , mInFlightCount(0)
+    , mCompletedCount(0)
+    , mDroppedCount(0)
+    , mMessage()
+    , mWorkerIdentity()
+    , mOutgoing()
+    , mPoller(nullptr)
+    , mIsFrontendRegistered(false)
+    , mIsRunning(true)
+    , mWorkers()
+{
+    CPPEROMQ_ASSERT(workerCount > 0);
+    CPPEROMQ_ASSERT(maxPendingRequests > 0);
+
+    mBackend.bind(mBackendEndpoint.c_str());
+
+    mWorkers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        mWorkers.emplace_back([this]() { runWorker(); });
+    }
+}
+
+inline
+AsyncServer::~AsyncServer()
+{
+    detach();
+
+    mIsRunning = false;
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+inline
+auto AsyncServer::attach(Poller& poller) -> void
+{
+    CPPEROMQ_ASSERT(nullptr == mPoller);
+
+    mPoller = &poller;
+    mPoller->add(isReceiveReady(mBackend, [this]() { processReplies(); }));
+    updateFrontendRegistration();
+}
+
+inline
+auto AsyncServer::detach() -> void
+{
+    if (nullptr == mPoller)
+    {
+        return;
+    }
+
+    if (mIsFrontendRegistered)
+    {
+        mPoller->remove(mFrontend);
+        mIsFrontendRegistered = false;
+    }
+
+    mPoller->remove(mBackend);
+    mPoller = nullptr;
+}
+
+inline
+auto AsyncServer::getWorkerCount() const -> size_t
+{
+    return mWorkers.size();
+}
+
+inline
+auto AsyncServer::getIdleWorkerCount() const -> size_t
+{
+    return mIdleWorkers.size();
+}
+
+inline
+auto AsyncServer::getPendingCount() const -> size_t
+{
+    return mPendingRequests.size();
+}
+
+inline
+auto AsyncServer::getInFlightCount() const -> size_t
+{
+    return mInFlightCount;
+}
+
+inline
+auto AsyncServer::getCompletedCount() const -> uint64_t
+{
+    return mCompletedCount;
+}
+
+inline
+auto AsyncServer::getDroppedCount() const -> uint64_t
+{
+    return mDroppedCount;
+}
+
+inline
+auto AsyncServer::processRequests() -> void
+{
+    while (mPendingRequests.size() < mMaxPendingRequests)
+    {
+        const Result result = mFrontend.tryReceive(ZMQ_DONTWAIT, mMessage);
+        if (result.isAgain())
+        {
+            break;
+        }
+
+        if (!checkResult(result))
+        {
+            continue;
+        }
+
+        auto delimiter = mMessage.begin();
+        while (delimiter != mMessage.end() && delimiter->size() != 0)
+        {
+            ++delimiter;
+        }
+
+        // Requests without an envelope cannot be replied to.
+        if (delimiter == mMessage.end() || delimiter == mMessage.begin())
+        {
+            continue;
+        }
+
+        auto body = delimiter;
+        ++body;
+
+        // Nor can requests without a body be handled.
+        if (body == mMessage.end())
+        {
+            continue;
+        }
+
+        const uint32_t index = allocateRequest();
+        Request& request = mRequests[index];
+
+        for (auto frame = mMessage.begin(); frame != body; ++frame)
+        {
+            request.envelope.emplace_back(std::move(*frame));
+        }
+
+        for (auto frame = body; frame != mMessage.end(); ++frame)
+        {
+            request.body.emplace_back(std::move(*frame));
+        }
+
+        if (mIdleWorkers.empty())
+        {
+            mPendingRequests.push_back(index);
+        }
+        else
+        {
+            dispatch(index);
+        }
+    }
+
+    updateFrontendRegistration();
+}
+
+inline
+auto AsyncServer::processReplies() -> void
+{
+    for (;;)
+    {
+        const Result result = mBackend.tryReceive(ZMQ_DONTWAIT, mWorkerIdentity, mMessage);
+        if (result.isAgain())
+        {
+            break;
+        }
+
+        if (!checkResult(result))
+        {
+            continue;
+        }
+
+        // Either a reply, [request id, frames...], or a bare empty frame
+        // from a worker that has just started.  Both mean it is idle.
+        if (mMessage[0].size() == sizeof(RequestId))
+        {
+            RequestId requestId;
+            std::memcpy(&requestId, mMessage[0].data(), sizeof(requestId));
+
+            const uint32_t index = static_cast<uint32_t>(requestId);
+            const uint32_t generation = static_cast<uint32_t>(requestId >> 32);
+            CPPEROMQ_ASSERT(index < mRequests.size() && mRequests[index].generation == generation);
+
+            Request& request = mRequests[index];
+
+            mOutgoing.clear();
+            for (OutgoingMessage& frame : request.envelope)
+            {
+                mOutgoing.emplace_back(std::move(frame));
+            }
+
+            auto frame = mMessage.begin();
+            for (++frame; frame != mMessage.end(); ++frame)
+            {
+                mOutgoing.emplace_back(std::move(*frame));
+            }
+
+            releaseRequest(index);
+            --mInFlightCount;
+            ++mCompletedCount;
+
+            // The I/O thread never waits on a single peer, so a reply that
+            // cannot be queued now is dropped.
+            const Result sendResult = mFrontend.trySend( ZMQ_DONTWAIT
+                                                       , std::make_move_iterator(mOutgoing.begin())
+                                                       , std::make_move_iterator(mOutgoing.end()) );
+            if (sendResult.isAgain() || EHOSTUNREACH == sendResult.getErrorNumber())
+            {
+                ++mDroppedCount;
+            }
+            else
+            {
+                checkResult(sendResult);
+            }
+        }
+
+        mIdleWorkers.push_back(std::move(mWorkerIdentity));
+        dispatchPending();
+    }
+
+    updateFrontendRegistration();
+}
+
+inline
+auto AsyncServer::allocateRequest() -> uint32_t
+{
+    if (mFreeRequests.empty())
+    {
+        mRequests.emplace_back();
+        mRequests.back().generation = 0;
+        return static_cast<uint32_t>(mRequests.size() - 1);
+    }
+
+    const uint32_t index = mFreeRequests.back();
+    mFreeRequests.pop_back();
+    return index;
+}
+
+inline
+auto AsyncServer::releaseRequest(const uint32_t index) -> void
+{
+    Request& request = mRequests[index];
+    request.envelope.clear();
+    request.body.clear();
+    ++request.generation;
+
+    mFreeRequests.push_back(index);
+}
+
+inline
+auto AsyncServer::dispatch(const uint32_t index) -> void
+{
+    CPPEROMQ_ASSERT(!mIdleWorkers.empty());
+
+    const RequestId requestId = makeRequestId(index, mRequests[index].generation);
+
+    mOutgoing.clear();
+    mOutgoing.emplace_back(std::move(mIdleWorkers.front()));
+    mOutgoing.emplace_back(sizeof(requestId), &requestId);
+    mIdleWorkers.pop_front();
+
+    for (OutgoingMessage& frame : mRequests[index].body)
+    {
+        mOutgoing.emplace_back(std::move(frame));
+    }
+
+    mRequests[index].body.clear();
+
+    mBackend.send( std::make_move_iterator(mOutgoing.begin())
+                 , std::make_move_iterator(mOutgoing.end()) );
+    ++mInFlightCount;
+}
+
+inline
+auto AsyncServer::dispatchPending() -> void
+{
+    while (!mIdleWorkers.empty() && !mPendingRequests.empty())
+    {
+        const uint32_t index = mPendingRequests.front();
+        mPendingRequests.pop_front();
+        dispatch(index);
+    }
+}
+
+inline
+auto AsyncServer::updateFrontendRegistration() -> void
+{
+    if (nullptr == mPoller)
+    {
+        return;
+    }
+
+    const bool isAccepting = (mPendingRequests.size() < mMaxPendingRequests);
+
+    if (isAccepting && !mIsFrontendRegistered)
+    {
+        mPoller->add(isReceiveReady(mFrontend, [this]() { processRequests(); }));
+        mIsFrontendRegistered = true;
+    }
+    else if (!isAccepting && mIsFrontendRegistered)
+    {
+        mPoller->remove(mFrontend);
+        mIsFrontendRegistered = false;
+    }
+}
+
+inline
+auto AsyncServer::runWorker() -> void
+{
+    DealerSocket socket = mContext.createDealerSocket();
+    socket.setLingerPeriod(0);
+    socket.setReceiveTimeout(WorkerStopInterval);
+    socket.connect(mBackendEndpoint.c_str());
+
+    socket.send(OutgoingMessage());
+
+    IncomingMessage requestId;
+    MultipartMessage request;
+    std::vector<OutgoingMessage> reply;
+
+    while (mIsRunning)
+    {
+        const Result result = socket.tryReceive(0, requestId, request);
+        if (result.isAgain())
+        {
+            continue;
+        }
+
+        reply.clear();
+
+        // A request that cannot be read (EPROTO) is still answered, empty,
+        // so that it completes and the worker is idle again.
+        if (checkResult(result))
+        {
+            mHandler(request, reply);
+        }
+
+        if (reply.empty())
+        {
+            reply.emplace_back();
+        }
+
+        OutgoingMessage(std::move(requestId)).sendAndRelease(socket, true);
+        socket.send( std::make_move_iterator(reply.begin())
+                   , std::make_move_iterator(reply.end()) );
+    }
+}
+
+inline
+auto AsyncServer::makeRequestId(const uint32_t index, const uint32_t generation) -> RequestId
+{
+    return ((static_cast<RequestId>(generation) << 32) | index);
+}
+
+}
@@ -0,0 +1,280 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Result.hpp>
+#include <CpperoMQ/Socket.hpp>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define CPPEROMQ_HAS_COROUTINES 1
+#else
+#define CPPEROMQ_HAS_COROUTINES 0
+#endif
+
+#if CPPEROMQ_HAS_COROUTINES
+
+#include <coroutine>
+#include <tuple>
+#include <utility>
+
+namespace CpperoMQ
+{
+
+// A send or receive that a suspended coroutine is waiting to complete.
+// tryComplete makes one non-blocking attempt and returns false on EAGAIN.
+// An operation without a coroutine handle is simply unparked once it
+// completes, which lets a reader stay parked on behalf of several coroutines.
+class AsyncOperation
+{
+public:
+    virtual auto tryComplete() -> bool = 0;
+
+    auto getHandle() const -> std::coroutine_handle<>;
+
+    // Links the operation into the queues of the context it is parked on.
+    auto getNext() const -> AsyncOperation*;
+    auto setNext(AsyncOperation* next) -> void;
+
+protected:
+    AsyncOperation() = default;
+    ~AsyncOperation() = default;
+
+    std::coroutine_handle<> mHandle;
+
+private:
+    AsyncOperation* mNext = nullptr;
+};
+
+// Resumes coroutines once their socket is ready.  The context running on the
+// current thread (see Scheduler::run) is found through getCurrent, which is
+// what lets asyncSend and asyncReceive be plain socket members.  An awaitable
+// that has to suspend with no current context throws Error(EFAULT).
+class AsyncContext
+{
+public:
+    // Parks 'operation' until 'socket' has 'events' (ZMQ_POLLIN or
+    // ZMQ_POLLOUT) and the operation completes.
+    virtual auto suspend(Socket& socket, const int events, AsyncOperation& operation) -> void = 0;
+
+    // Unparks 'operation' without completing it.
+    virtual auto cancel(Socket& socket, AsyncOperation& operation) -> void = 0;
+
+    // Resumes 'handle' later from the context's loop.  For awaitables that
+    // are completed by something other than their own socket.
+    virtual auto schedule(std::coroutine_handle<> handle) -> void = 0;
+
+    static auto getCurrent() -> AsyncContext*;
+
+protected:
+    AsyncContext() = default;
+    ~AsyncContext() = default;
+
+    static auto setCurrent(AsyncContext* context) -> AsyncContext*;
+
+private:
+    static auto current() -> AsyncContext*&;
+};
+
+// Returned by SendingSocket::asyncSend.  Temporaries passed to asyncSend are
+// moved into the awaitable; other parts are referenced and must outlive it.
+template <typename S, typename... SendableTypes>
+class SendAwaitable final : public AsyncOperation
+{
+public:
+    template <typename... Parts>
+    explicit SendAwaitable(S& socket, Parts&&... parts);
+
+    auto await_ready() -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) -> void;
+    auto await_resume() -> bool;
+
+    virtual auto tryComplete() -> bool override;
+
+private:
+    S& mSocket;
+    std::tuple<SendableTypes...> mSendables;
+    Result mResult;
+};
+
+// Returned by ReceivingSocket::asyncReceive.
+template <typename S, typename... ReceivableTypes>
+class ReceiveAwaitable final : public AsyncOperation
+{
+public:
+    explicit ReceiveAwaitable(S& socket, ReceivableTypes&... receivables);
+
+    auto await_ready() -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) -> void;
+    auto await_resume() -> bool;
+
+    virtual auto tryComplete() -> bool override;
+
+private:
+    S& mSocket;
+    std::tuple<ReceivableTypes&...> mReceivables;
+    Result mResult;
+};
+
+inline
+auto AsyncOperation::getHandle() const -> std::coroutine_handle<>
+{
+    return mHandle;
+}
+
+inline
+auto AsyncOperation::getNext() const -> AsyncOperation*
+{
+    return mNext;
+}
+
+inline
+auto AsyncOperation::setNext(AsyncOperation* next) -> void
+{
+    mNext = next;
+}
+
+inline
+auto AsyncContext::getCurrent() -> AsyncContext*
+{
+    return current();
+}
+
+inline
+auto AsyncContext::setCurrent(AsyncContext* context) -> AsyncContext*
+{
+    AsyncContext* previous = current();
+    current() = context;
+    return previous;
+}
+
+inline
+auto AsyncContext::current() -> AsyncContext*&
+{
+    thread_local AsyncContext* context = nullptr;
+    return context;
+}
+
+template <typename S, typename... SendableTypes>
+template <typename... Parts>
+inline
+SendAwaitable<S, SendableTypes...>::SendAwaitable(S& socket, Parts&&... parts)
+    : mSocket(socket)
+    , mSendables(std::forward<Parts>(parts)...)
+    , mResult()
+{
+}
+
+template <typename S, typename... SendableTypes>
+inline
+auto SendAwaitable<S, SendableTypes...>::await_ready() -> bool
+{
+    return tryComplete();
+}
+
+template <typename S, typename... SendableTypes>
+inline
+auto SendAwaitable<S, SendableTypes...>::await_suspend(std::coroutine_handle<> handle) -> void
+{
+    AsyncContext* context = AsyncContext::getCurrent();
+    if (nullptr == context)
+    {
+        throw Error(EFAULT);
+    }
+
+    mHandle = handle;
+    context->suspend(mSocket, ZMQ_POLLOUT, *this);
+}
+
+template <typename S, typename... SendableTypes>
+inline
+auto SendAwaitable<S, SendableTypes...>::await_resume() -> bool
+{
+    return (checkResult(mResult));
+}
+
+template <typename S, typename... SendableTypes>
+inline
+auto SendAwaitable<S, SendableTypes...>::tryComplete() -> bool
+{
+    // Parts held by value are sent as rvalues, i.e. without a shallow copy.
+    mResult = std::apply( [this](auto&... sendables)
+                          {
+                              return mSocket.trySend( ZMQ_DONTWAIT
+                                                    , std::forward<SendableTypes>(sendables)... );
+                          }
+                        , mSendables );
+    return (!mResult.isAgain());
+}
+
+template <typename S, typename... ReceivableTypes>
+inline
+ReceiveAwaitable<S, ReceivableTypes...>::ReceiveAwaitable(S& socket, ReceivableTypes&... receivables)
+    : mSocket(socket)
+    , mReceivables(receivables...)
+    , mResult()
+{
+}
+
+template <typename S, typename... ReceivableTypes>
+inline
+auto ReceiveAwaitable<S, ReceivableTypes...>::await_ready() -> bool
+{
+    return tryComplete();
+}
+
+template <typename S, typename... ReceivableTypes>
+inline
+auto ReceiveAwaitable<S, ReceivableTypes...>::await_suspend(std::coroutine_handle<> handle) -> void
+{
+    AsyncContext* context = AsyncContext::getCurrent();
+    if (nullptr == context)
+    {
+        throw Error(EFAULT);
+    }
+
+    mHandle = handle;
+    context->suspend(mSocket, ZMQ_POLLIN, *this);
+}
+
+template <typename S, typename... ReceivableTypes>
+inline
+auto ReceiveAwaitable<S, ReceivableTypes...>::await_resume() -> bool
+{
+    return (checkResult(mResult));
+}
+
+template <typename S, typename... ReceivableTypes>
+inline
+auto ReceiveAwaitable<S, ReceivableTypes...>::tryComplete() -> bool
+{
+    mResult = std::apply( [this](auto&... receivables)
+                          {
+                              return mSocket.tryReceive(ZMQ_DONTWAIT, receivables...);
+                          }
+                        , mReceivables );
+    return (!mResult.isAgain());
+}
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Receivable.hpp>
+#include <CpperoMQ/Socket.hpp>
+
+namespace CpperoMQ
+{
+
+// Receives a frame straight into a caller-owned buffer via zmq_recv, skipping
+// the zmq_msg_t lifecycle.  Frames larger than the buffer are truncated.
+class BufferReceiver final : public Receivable
+{
+public:
+    BufferReceiver(void* buffer, const size_t capacity);
+    virtual ~BufferReceiver() = default;
+    BufferReceiver(const BufferReceiver& other) = delete;
+    BufferReceiver(BufferReceiver&& other) = default;
+    BufferReceiver& operator=(const BufferReceiver& other) = delete;
+    BufferReceiver& operator=(BufferReceiver&& other) = default;
+
+    auto capacity() const -> size_t;
+    auto size() const -> size_t;
+    auto data() const -> const void*;
+    auto charData() const -> const char*;
+
+    auto getFrameSize() const -> size_t;
+    auto isTruncated() const -> bool;
+
+    virtual auto receive(Socket& socket, bool& moreToReceive) -> bool override;
+    virtual auto tryReceive( Socket& socket
+                           , bool& moreToReceive
+                           , const int flags ) NOEXCEPT -> Result override;
+
+private:
+    void* mBuffer;
+    size_t mCapacity;
+    size_t mFrameSize;
+};
+
+inline
+BufferReceiver::BufferReceiver(void* buffer, const size_t capacity)
+    : mBuffer(buffer)
+    , mCapacity(capacity)
+    , mFrameSize(0)
+{
+    CPPEROMQ_ASSERT(nullptr != buffer || 0 == capacity);
+}
+
+inline
+auto BufferReceiver::capacity() const -> size_t
+{
+    return mCapacity;
+}
+
+inline
+auto BufferReceiver::size() const -> size_t
+{
+    return (isTruncated()) ? mCapacity : mFrameSize;
+}
+
+inline
+auto BufferReceiver::data() const -> const void*
+{
+    return mBuffer;
+}
+
+inline
+auto BufferReceiver::charData() const -> const char*
+{
+    return (static_cast<const char*>(mBuffer));
+}
+
+inline
+auto BufferReceiver::getFrameSize() const -> size_t
+{
+    return mFrameSize;
+}
+
+inline
+auto BufferReceiver::isTruncated() const -> bool
+{
+    return (mFrameSize > mCapacity);
+}
+
+inline
+auto BufferReceiver::receive(Socket& socket, bool& moreToReceive) -> bool
+{
+    return (checkResult(tryReceive(socket, moreToReceive, 0)));
+}
+
+inline
+auto BufferReceiver::tryReceive( Socket& socket
+                               , bool& moreToReceive
+                               , const int flags ) NOEXCEPT -> Result
+{
+    CPPEROMQ_ASSERT(nullptr != socket.mSocket);
+
+    moreToReceive = false;
+
+    const int result = zmq_recv(socket.mSocket, mBuffer, mCapacity, flags);
+    if (result >= 0)
+    {
+        mFrameSize = static_cast<size_t>(result);
+
+        int more = 0;
+        size_t moreLength = sizeof(more);
+        if (0 != zmq_getsockopt(socket.mSocket, ZMQ_RCVMORE, &more, &moreLength))
+        {
+            return (Result::fromErrno());
+        }
+
+        moreToReceive = (0 != more);
+        return (Result());
+    }
+
+    return (Result::fromErrno());
+}
+
+}
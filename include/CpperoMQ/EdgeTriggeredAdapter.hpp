@@ -0,0 +1,121 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/MultipartMessage.hpp>
+#include <CpperoMQ/Socket.hpp>
+
+namespace CpperoMQ
+{
+
+// Lets an external event loop (epoll, kqueue, io_uring, ...) drive a socket
+// through its ZMQ_FD.  That descriptor is edge-triggered: libzmq signals it
+// only when ZMQ_EVENTS may have changed, and it does not stay readable while
+// messages are queued.  So every time the descriptor becomes readable, and
+// once after it is first registered, the socket must be drained until EAGAIN
+// and ZMQ_EVENTS then rechecked, or a wakeup can be lost.  This adapter does
+// exactly that.
+template <typename S>
+class EdgeTriggeredAdapter
+{
+public:
+    explicit EdgeTriggeredAdapter(S& socket);
+    EdgeTriggeredAdapter(const EdgeTriggeredAdapter& other) = default;
+    EdgeTriggeredAdapter& operator=(const EdgeTriggeredAdapter& other) = default;
+
+    auto getFileDescriptor() const -> Socket::FileDescriptor;
+
+    // Receives every message that is ready, each into 'storage' before it is
+    // handed to 'handler', and stops only once ZMQ_EVENTS confirms that
+    // nothing arrived since the last EAGAIN.  Messages are received in
+    // batches of at most 'batchSize' between checks.  Returns the number of
+    // messages received.
+    template <typename Handler>
+    auto receiveAll( MultipartMessage& storage
+                   , Handler&& handler
+                   , const size_t batchSize = 64 ) -> size_t;
+
+    // Reads ZMQ_EVENTS.  Reading it can consume the descriptor's edge, so
+    // call these only after handling a wakeup, not instead of receiveAll.
+    auto isReceiveReady() const -> bool;
+    auto isSendReady() const    -> bool;
+
+private:
+    S* mSocket;
+};
+
+template <typename S>
+inline
+EdgeTriggeredAdapter<S>::EdgeTriggeredAdapter(S& socket)
+    : mSocket(&socket)
+{
+}
+
+template <typename S>
+inline
+auto EdgeTriggeredAdapter<S>::getFileDescriptor() const -> Socket::FileDescriptor
+{
+    return (mSocket->getFileDescriptor());
+}
+
+template <typename S>
+template <typename Handler>
+inline
+auto EdgeTriggeredAdapter<S>::receiveAll( MultipartMessage& storage
+                                        , Handler&& handler
+                                        , const size_t batchSize ) -> size_t
+{
+    CPPEROMQ_ASSERT(batchSize > 0);
+
+    size_t receivedCount = 0;
+
+    do
+    {
+        size_t batchCount = 0;
+        do
+        {
+            batchCount = mSocket->drain(batchSize, storage, handler);
+            receivedCount += batchCount;
+        }
+        while (batchCount == batchSize);
+    }
+    while (isReceiveReady());
+
+    return receivedCount;
+}
+
+template <typename S>
+inline
+auto EdgeTriggeredAdapter<S>::isReceiveReady() const -> bool
+{
+    return (0 != (mSocket->getPendingEvents() & ZMQ_POLLIN));
+}
+
+template <typename S>
+inline
+auto EdgeTriggeredAdapter<S>::isSendReady() const -> bool
+{
+    return (0 != (mSocket->getPendingEvents() & ZMQ_POLLOUT));
+}
+
+}
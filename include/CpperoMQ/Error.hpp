@@ -32,6 +32,7 @@ class Error final : public std::exception
 {
 public:
     Error();
+    explicit Error(const int errorNumber);
 
     virtual auto what() const NOEXCEPT -> const char* override;
     auto number() const -> int;
@@ -46,6 +47,12 @@ Error::Error()
 {
 }
 
+inline
+Error::Error(const int errorNumber)
+    : mErrorNumber(errorNumber)
+{
+}
+
 inline
 auto Error::what() const NOEXCEPT -> const char*
 {
@@ -25,12 +25,18 @@
 #include <CpperoMQ/Message.hpp>
 #include <CpperoMQ/Receivable.hpp>
 #include <CpperoMQ/Socket.hpp>
+#include <CpperoMQ/Span.hpp>
+
+#include <cstdint>
+#include <type_traits>
 
 namespace CpperoMQ
 {
 
 class IncomingMessage final : public Message, public Receivable
 {
+    friend class OutgoingMessage;
+
 public:
     IncomingMessage();
     virtual ~IncomingMessage() = default;
@@ -43,7 +49,27 @@ public:
     auto data() const -> const void*;
     auto charData() const -> const char*;
 
+    // Typed access to the frame's data without copying.  view() requires the
+    // frame to hold exactly one T and span() a whole number of Ts; both
+    // require the data to be suitably aligned for T and return an empty
+    // result otherwise.  copyTo() and viewOrCopy() fall back to copying when
+    // the data is misaligned.
+    template <typename T>
+    auto view() const -> const T*;
+
+    template <typename T>
+    auto span() const -> Span<const T>;
+
+    template <typename T>
+    auto copyTo(T& value) const -> bool;
+
+    template <typename T>
+    auto viewOrCopy(T& storage) const -> const T*;
+
     virtual auto receive(Socket& socket, bool& moreToReceive) -> bool override;
+    virtual auto tryReceive( Socket& socket
+                           , bool& moreToReceive
+                           , const int flags ) NOEXCEPT -> Result override;
 };
 
 inline
@@ -87,39 +113,106 @@ auto IncomingMessage::charData() const -> const char*
     return (static_cast<const char*>(data()));
 }
 
+template <typename T>
+inline
+auto IncomingMessage::view() const -> const T*
+{
+    static_assert( std::is_trivially_copyable<T>::value
+                 , "Template parameter 'T' must be trivially copyable." );
+
+    const void* msgData = data();
+    if (sizeof(T) != size() ||
+        0 != (reinterpret_cast<std::uintptr_t>(msgData) % std::alignment_of<T>::value))
+    {
+        return nullptr;
+    }
+
+    return (static_cast<const T*>(msgData));
+}
+
+template <typename T>
+inline
+auto IncomingMessage::span() const -> Span<const T>
+{
+    static_assert( std::is_trivially_copyable<T>::value
+                 , "Template parameter 'T' must be trivially copyable." );
+
+    const void* msgData = data();
+    const size_t msgSize = size();
+    if (0 == msgSize ||
+        0 != (msgSize % sizeof(T)) ||
+        0 != (reinterpret_cast<std::uintptr_t>(msgData) % std::alignment_of<T>::value))
+    {
+        return Span<const T>();
+    }
+
+    return Span<const T>(static_cast<const T*>(msgData), msgSize / sizeof(T));
+}
+
+template <typename T>
+inline
+auto IncomingMessage::copyTo(T& value) const -> bool
+{
+    static_assert( std::is_trivially_copyable<T>::value
+                 , "Template parameter 'T' must be trivially copyable." );
+
+    if (sizeof(T) != size())
+    {
+        return false;
+    }
+
+    memcpy(&value, data(), sizeof(T));
+    return true;
+}
+
+template <typename T>
+inline
+auto IncomingMessage::viewOrCopy(T& storage) const -> const T*
+{
+    const T* valuePtr = view<T>();
+    if (nullptr != valuePtr)
+    {
+        return valuePtr;
+    }
+
+    return (copyTo(storage)) ? &storage : nullptr;
+}
+
 inline
 auto IncomingMessage::receive(Socket& socket, bool& moreToReceive) -> bool
+{
+    return (checkResult(tryReceive(socket, moreToReceive, 0)));
+}
+
+inline
+auto IncomingMessage::tryReceive( Socket& socket
+                                , bool& moreToReceive
+                                , const int flags ) NOEXCEPT -> Result
 {
     zmq_msg_t* msgPtr = getInternalMessage();
 
     CPPEROMQ_ASSERT(nullptr != msgPtr);
     CPPEROMQ_ASSERT(nullptr != socket.mSocket);
 
+    moreToReceive = false;
+
     if (0 != zmq_msg_close(msgPtr))
     {
-        throw Error();
+        return (Result::fromErrno());
     }
 
     if (0 != zmq_msg_init(msgPtr))
     {
-        throw Error();
+        return (Result::fromErrno());
     }
 
-    moreToReceive = false;
-
-    const int flags = 0;
     if (zmq_msg_recv(msgPtr, socket.mSocket, flags) >= 0)
     {
         moreToReceive = (0 != zmq_msg_more(msgPtr));
-        return true;
-    }
-
-    if (zmq_errno() == EAGAIN)
-    {
-        return false;
+        return (Result());
     }
 
-    throw Error();
+    return (Result::fromErrno());
 }
 
 }
@@ -0,0 +1,291 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <CpperoMQ/OutgoingMessage.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace CpperoMQ
+{
+
+// A read-only memory mapping of a file region whose pages are sent without
+// being copied onto the heap.  Messages created from the mapping keep it
+// alive; it is unmapped once the MappedFile and every message (including
+// libzmq's copies) have been released.
+class MappedFile
+{
+public:
+    explicit MappedFile(const char* path);
+    MappedFile(const char* path, const size_t offset, const size_t length);
+    ~MappedFile();
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other);
+
+    friend auto swap(MappedFile& lhs, MappedFile& rhs) -> void;
+
+    auto size() const -> size_t;
+
+    auto createMessage() const -> OutgoingMessage;
+    auto createMessage(const size_t offset, const size_t length) const -> OutgoingMessage;
+
+    // Splits the region into frames of 'chunkSize' bytes, rounded up to a
+    // whole number of pages.  Frames after the first start on page
+    // boundaries of the file, so the first frame is shorter if the region
+    // does not start on one, and the last frame may be shorter too.
+    auto createChunkedMessages(const size_t chunkSize) const -> std::vector<OutgoingMessage>;
+
+    static auto getPageSize() -> size_t;
+
+private:
+    struct Mapping
+    {
+        auto releaseReference() -> void;
+
+        void* address;
+        size_t mappedLength;
+        char* data;
+        size_t size;
+        std::atomic<size_t> references;
+    };
+
+    static auto release(void* data, void* hint) -> void;
+
+    Mapping* mMapping;
+};
+
+inline
+MappedFile::MappedFile(const char* path)
+    : MappedFile(path, 0, static_cast<size_t>(-1))
+{
+}
+
+inline
+MappedFile::MappedFile(const char* path, const size_t offset, const size_t length)
+    : mMapping(nullptr)
+{
+    CPPEROMQ_ASSERT(nullptr != path);
+
+    // Allocated up front so that nothing can throw between mmap and the
+    // mapping being owned.
+    std::unique_ptr<Mapping> mapping(new Mapping());
+
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw Error(errno);
+    }
+
+    struct stat fileStatus;
+    if (0 != fstat(fd, &fileStatus))
+    {
+        const int errorNumber = errno;
+        close(fd);
+        throw Error(errorNumber);
+    }
+
+    const size_t fileSize = static_cast<size_t>(fileStatus.st_size);
+    if (offset > fileSize)
+    {
+        close(fd);
+        throw Error(EINVAL);
+    }
+
+    const size_t regionSize = std::min(length, fileSize - offset);
+    const size_t mapOffset  = offset & ~(getPageSize() - 1);
+    const size_t mapLength  = regionSize + (offset - mapOffset);
+
+    void* address = nullptr;
+    if (regionSize > 0)
+    {
+        address = mmap( nullptr
+                      , mapLength
+                      , PROT_READ
+                      , MAP_PRIVATE
+                      , fd
+                      , static_cast<off_t>(mapOffset) );
+        if (MAP_FAILED == address)
+        {
+            const int errorNumber = errno;
+            close(fd);
+            throw Error(errorNumber);
+        }
+    }
+
+    close(fd);
+
+    mapping->address = address;
+    mapping->mappedLength = (regionSize > 0) ? mapLength : 0;
+    mapping->data = (regionSize > 0) ? static_cast<char*>(address) + (offset - mapOffset) : nullptr;
+    mapping->size = regionSize;
+    mapping->references.store(1);
+    mMapping = mapping.release();
+}
+
+inline
+MappedFile::~MappedFile()
+{
+    if (mMapping)
+    {
+        mMapping->releaseReference();
+        mMapping = nullptr;
+    }
+}
+
+inline
+MappedFile::MappedFile(MappedFile&& other)
+    : mMapping(nullptr)
+{
+    swap(*this, other);
+}
+
+inline
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    swap(*this, other);
+    return (*this);
+}
+
+inline
+auto MappedFile::size() const -> size_t
+{
+    return (mMapping) ? mMapping->size : 0;
+}
+
+inline
+auto MappedFile::createMessage() const -> OutgoingMessage
+{
+    return (createMessage(0, size()));
+}
+
+inline
+auto MappedFile::createMessage(const size_t offset, const size_t length) const -> OutgoingMessage
+{
+    CPPEROMQ_ASSERT(nullptr != mMapping);
+    CPPEROMQ_ASSERT(offset <= mMapping->size);
+    CPPEROMQ_ASSERT(length <= mMapping->size - offset);
+
+    if (0 == length)
+    {
+        return OutgoingMessage();
+    }
+
+    mMapping->references.fetch_add(1, std::memory_order_relaxed);
+
+    try
+    {
+        return (OutgoingMessage(length, mMapping->data + offset, &MappedFile::release, mMapping));
+    }
+    catch (...)
+    {
+        mMapping->releaseReference();
+        throw;
+    }
+}
+
+inline
+auto MappedFile::createChunkedMessages(const size_t chunkSize) const -> std::vector<OutgoingMessage>
+{
+    CPPEROMQ_ASSERT(chunkSize > 0);
+
+    const size_t pageSize = getPageSize();
+    const size_t alignedChunkSize = ((chunkSize + pageSize - 1) / pageSize) * pageSize;
+    const size_t totalSize = size();
+
+    std::vector<OutgoingMessage> chunks;
+    if (0 == totalSize)
+    {
+        return chunks;
+    }
+
+    // The mapping starts on the page that holds the region's first byte, so
+    // this is the region's offset within that page of the file.
+    const size_t pageOffset = static_cast<size_t>(mMapping->data - static_cast<char*>(mMapping->address));
+
+    chunks.reserve((pageOffset + totalSize + alignedChunkSize - 1) / alignedChunkSize);
+
+    size_t offset = 0;
+    size_t length = alignedChunkSize - pageOffset;
+    while (offset < totalSize)
+    {
+        length = std::min(length, totalSize - offset);
+        chunks.push_back(createMessage(offset, length));
+        offset += length;
+        length = alignedChunkSize;
+    }
+
+    return chunks;
+}
+
+inline
+auto MappedFile::getPageSize() -> size_t
+{
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return pageSize;
+}
+
+inline
+auto MappedFile::Mapping::releaseReference() -> void
+{
+    if (1 == references.fetch_sub(1, std::memory_order_acq_rel))
+    {
+        if (nullptr != address)
+        {
+            const int result = munmap(address, mappedLength);
+            CPPEROMQ_ASSERT(0 == result);
+        }
+
+        delete this;
+    }
+}
+
+inline
+auto MappedFile::release(void* data, void* hint) -> void
+{
+    (void)data;
+    static_cast<Mapping*>(hint)->releaseReference();
+}
+
+inline
+auto swap(MappedFile& lhs, MappedFile& rhs) -> void
+{
+    using std::swap;
+    swap(lhs.mMapping, rhs.mMapping);
+}
+
+}
+
+#endif
@@ -41,6 +41,10 @@ public:
 protected:
     Message();
     Message(const size_t size, const void* sourceData);
+    Message( const size_t size
+           , void* data
+           , zmq_free_fn* freeFunction
+           , void* hint );
 
     auto getInternalMessage() const -> const zmq_msg_t* const;
     auto getInternalMessage()       ->       zmq_msg_t*;
@@ -96,6 +100,21 @@ Message::Message(const size_t size, const void* sourceData)
     memcpy(msgData, sourceData, size);
 }
 
+inline
+Message::Message( const size_t size
+                , void* data
+                , zmq_free_fn* freeFunction
+                , void* hint )
+{
+    CPPEROMQ_ASSERT(nullptr != data || 0 == size);
+
+    // On failure, ownership of 'data' stays with the caller.
+    if (0 != zmq_msg_init_data(&mMsg, data, size, freeFunction, hint))
+    {
+        throw Error();
+    }
+}
+
 inline
 auto Message::getInternalMessage() const -> const zmq_msg_t* const
 {
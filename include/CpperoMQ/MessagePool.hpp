@@ -0,0 +1,330 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/OutgoingMessage.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+// Serves message payloads from power-of-two size classes carved out of large
+// slabs.  A pool is meant to be owned by one sending thread; payloads may be
+// released from any thread (normally a libzmq I/O thread) and are recycled
+// without locking.  Payloads small enough for libzmq to store inline, and
+// those above the largest size class, bypass the pool.
+class MessagePool
+{
+public:
+    MessagePool( const size_t maxBlockSize = 64 * 1024
+               , const size_t slabSize = 256 * 1024 );
+    ~MessagePool();
+    MessagePool(const MessagePool& other) = delete;
+    MessagePool(MessagePool&& other);
+    MessagePool& operator=(const MessagePool& other) = delete;
+    MessagePool& operator=(MessagePool&& other);
+
+    friend auto swap(MessagePool& lhs, MessagePool& rhs) -> void;
+
+    auto createMessage(const size_t size, const void* sourceData) -> OutgoingMessage;
+
+    // 'filler' is called as filler(void* data, size_t size) to write the
+    // payload in place.
+    template <typename Filler>
+    auto fillMessage(const size_t size, Filler&& filler) -> OutgoingMessage;
+
+    auto getHitCount() const  -> uint64_t;
+    auto getMissCount() const -> uint64_t;
+
+private:
+    struct Arena;
+
+    struct Block
+    {
+        Block* next;
+        Arena* arena;
+        size_t classIndex;
+    };
+
+    struct SizeClass
+    {
+        Block* localFree;
+        size_t blockSize;
+        // Keeps the cross-thread free list off the cache lines the owning
+        // thread touches.
+        char padding[64];
+        std::atomic<Block*> remoteFree;
+        char trailingPadding[64];
+    };
+
+    struct Arena
+    {
+        Arena(const size_t maxBlockSize, const size_t slabSize);
+
+        auto acquire(const size_t size) -> Block*;
+        auto refill(SizeClass& sizeClass, const size_t classIndex) -> void;
+        auto releaseReference() -> void;
+
+        std::unique_ptr<SizeClass[]> sizeClasses;
+        size_t sizeClassCount;
+        size_t slabSize;
+        std::vector<std::unique_ptr<char[]>> slabs;
+        std::atomic<size_t> references;
+        uint64_t hits;
+        uint64_t misses;
+    };
+
+    static const size_t MinBlockSize = 64;
+    static const size_t InlineMessageSize = 32;
+    static const size_t HeaderSize = (sizeof(Block) + 15) & ~static_cast<size_t>(15);
+
+    static auto getPayload(Block* block) -> void*;
+    static auto release(void* data, void* hint) -> void;
+    static auto wrap(Block* block, const size_t size) -> OutgoingMessage;
+
+    Arena* mArena;
+};
+
+inline
+MessagePool::MessagePool(const size_t maxBlockSize, const size_t slabSize)
+    : mArena(new Arena(maxBlockSize, slabSize))
+{
+}
+
+inline
+MessagePool::~MessagePool()
+{
+    // Payloads still held by libzmq keep the slabs alive.
+    if (mArena)
+    {
+        mArena->releaseReference();
+        mArena = nullptr;
+    }
+}
+
+inline
+MessagePool::MessagePool(MessagePool&& other)
+    : mArena(nullptr)
+{
+    swap(*this, other);
+}
+
+inline
+MessagePool& MessagePool::operator=(MessagePool&& other)
+{
+    swap(*this, other);
+    return (*this);
+}
+
+inline
+auto MessagePool::createMessage(const size_t size, const void* sourceData) -> OutgoingMessage
+{
+    CPPEROMQ_ASSERT(nullptr != mArena);
+
+    Block* block = mArena->acquire(size);
+    if (nullptr == block)
+    {
+        return (OutgoingMessage(size, sourceData));
+    }
+
+    memcpy(getPayload(block), sourceData, size);
+    return (wrap(block, size));
+}
+
+template <typename Filler>
+inline
+auto MessagePool::fillMessage(const size_t size, Filler&& filler) -> OutgoingMessage
+{
+    CPPEROMQ_ASSERT(nullptr != mArena);
+
+    Block* block = mArena->acquire(size);
+    if (nullptr == block)
+    {
+        std::vector<char> buffer(size);
+        filler(static_cast<void*>(buffer.data()), size);
+        return (OutgoingMessage(std::move(buffer)));
+    }
+
+    filler(getPayload(block), size);
+    return (wrap(block, size));
+}
+
+inline
+auto MessagePool::getHitCount() const -> uint64_t
+{
+    return (mArena) ? mArena->hits : 0;
+}
+
+inline
+auto MessagePool::getMissCount() const -> uint64_t
+{
+    return (mArena) ? mArena->misses : 0;
+}
+
+inline
+MessagePool::Arena::Arena(const size_t maxBlockSize, const size_t slabSize)
+    : sizeClasses()
+    , sizeClassCount(1)
+    , slabSize(slabSize)
+    , slabs()
+    , references(1)
+    , hits(0)
+    , misses(0)
+{
+    for (size_t blockSize = MinBlockSize; blockSize < maxBlockSize; blockSize *= 2)
+    {
+        ++sizeClassCount;
+    }
+
+    sizeClasses.reset(new SizeClass[sizeClassCount]);
+    for (size_t i = 0; i < sizeClassCount; ++i)
+    {
+        sizeClasses[i].localFree = nullptr;
+        sizeClasses[i].blockSize = MinBlockSize << i;
+        sizeClasses[i].remoteFree.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+inline
+auto MessagePool::Arena::acquire(const size_t size) -> Block*
+{
+    if (size <= InlineMessageSize)
+    {
+        return nullptr;
+    }
+
+    size_t classIndex = 0;
+    while (classIndex < sizeClassCount && sizeClasses[classIndex].blockSize < size)
+    {
+        ++classIndex;
+    }
+
+    if (classIndex == sizeClassCount)
+    {
+        ++misses;
+        return nullptr;
+    }
+
+    SizeClass& sizeClass = sizeClasses[classIndex];
+    if (nullptr == sizeClass.localFree)
+    {
+        sizeClass.localFree = sizeClass.remoteFree.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (nullptr != sizeClass.localFree)
+    {
+        ++hits;
+    }
+    else
+    {
+        ++misses;
+        refill(sizeClass, classIndex);
+    }
+
+    Block* block = sizeClass.localFree;
+    sizeClass.localFree = block->next;
+
+    references.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+inline
+auto MessagePool::Arena::refill(SizeClass& sizeClass, const size_t classIndex) -> void
+{
+    const size_t stride = HeaderSize + sizeClass.blockSize;
+    const size_t blockCount = (slabSize > stride) ? (slabSize / stride) : 1;
+
+    std::unique_ptr<char[]> slab(new char[blockCount * stride]);
+    for (size_t i = 0; i < blockCount; ++i)
+    {
+        Block* block = reinterpret_cast<Block*>(slab.get() + (i * stride));
+        block->next = sizeClass.localFree;
+        block->arena = this;
+        block->classIndex = classIndex;
+        sizeClass.localFree = block;
+    }
+
+    slabs.push_back(std::move(slab));
+}
+
+inline
+auto MessagePool::Arena::releaseReference() -> void
+{
+    if (1 == references.fetch_sub(1, std::memory_order_acq_rel))
+    {
+        delete this;
+    }
+}
+
+inline
+auto MessagePool::getPayload(Block* block) -> void*
+{
+    return (reinterpret_cast<char*>(block) + HeaderSize);
+}
+
+inline
+auto MessagePool::release(void* data, void* hint) -> void
+{
+    (void)data;
+
+    Block* block = static_cast<Block*>(hint);
+    Arena* arena = block->arena;
+    SizeClass& sizeClass = arena->sizeClasses[block->classIndex];
+
+    block->next = sizeClass.remoteFree.load(std::memory_order_relaxed);
+    while (!sizeClass.remoteFree.compare_exchange_weak( block->next
+                                                      , block
+                                                      , std::memory_order_release
+                                                      , std::memory_order_relaxed ))
+    {
+    }
+
+    arena->releaseReference();
+}
+
+inline
+auto MessagePool::wrap(Block* block, const size_t size) -> OutgoingMessage
+{
+    try
+    {
+        return (OutgoingMessage(size, getPayload(block), &MessagePool::release, block));
+    }
+    catch (...)
+    {
+        release(getPayload(block), block);
+        throw;
+    }
+}
+
+inline
+auto swap(MessagePool& lhs, MessagePool& rhs) -> void
+{
+    using std::swap;
+    swap(lhs.mArena, rhs.mArena);
+}
+
+}
@@ -22,8 +22,12 @@
 
 #pragma once
 
+#include <CpperoMQ/Awaitable.hpp>
+#include <CpperoMQ/MultipartMessage.hpp>
 #include <CpperoMQ/Receivable.hpp>
 
+#include <type_traits>
+
 namespace CpperoMQ
 {
 namespace Mixins
@@ -40,9 +44,59 @@ public:
     ReceivingSocket& operator=(ReceivingSocket& other) = delete;
     ReceivingSocket& operator=(ReceivingSocket&& other);
 
+    // Each part may be a Receivable or a StaticReceivable.  Parts are
+    // dispatched on their static type, so StaticReceivable and final
+    // Receivable parts are received without a virtual call.
+    template <typename ReceivableType, typename... ReceivableTypes>
+    auto receive( ReceivableType& receivable
+                , ReceivableTypes&... receivables )
+        -> typename std::enable_if<IsReceivable<ReceivableType>::value, bool>::type;
+
+    // Non-throwing counterpart of receive.  A message with more or fewer
+    // parts than receivables is reported as EPROTO.
+    template <typename ReceivableType, typename... ReceivableTypes>
+    auto tryReceive( ReceivableType& receivable
+                   , ReceivableTypes&... receivables )
+        -> typename std::enable_if<IsReceivable<ReceivableType>::value, Result>::type;
+
+    // Receives with extra libzmq flags for this call only.  With ZMQ_DONTWAIT,
+    // a receive that would block fails with EAGAIN instead, regardless of the
+    // socket's receive timeout.
+    template <typename ReceivableType, typename... ReceivableTypes>
+    auto receive( const int flags
+                , ReceivableType& receivable
+                , ReceivableTypes&... receivables )
+        -> typename std::enable_if<IsReceivable<ReceivableType>::value, bool>::type;
+
+    template <typename ReceivableType, typename... ReceivableTypes>
+    auto tryReceive( const int flags
+                   , ReceivableType& receivable
+                   , ReceivableTypes&... receivables )
+        -> typename std::enable_if<IsReceivable<ReceivableType>::value, Result>::type;
+
+    // Receives up to 'maxMessages' messages that are already queued, without
+    // blocking.  Each message is received into 'storage', which is reused,
+    // and handed to 'handler' before the next one is received.  Returns the
+    // number of messages received.
+    template <typename Handler>
+    auto drain( const size_t maxMessages
+              , MultipartMessage& storage
+              , Handler&& handler ) -> size_t;
+
+    // Receives already queued messages, without blocking, into consecutive
+    // MultipartMessages of a range until it is full or the socket is empty.
+    // Returns the number of messages received.
+    template <typename Iterator>
+    auto drain(Iterator first, Iterator last) -> size_t;
+
+#if CPPEROMQ_HAS_COROUTINES
+    // Receives from a coroutine run by a Scheduler.  The receive is attempted
+    // straight away and the coroutine is only suspended, until the socket is
+    // readable, if it would block.  co_await yields what receive would have.
     template <typename... ReceivableTypes>
-    auto receive( Receivable& receivable
-                , ReceivableTypes&... receivables ) -> bool;
+    auto asyncReceive(ReceivableTypes&... receivables)
+        -> ReceiveAwaitable<ReceivingSocket, ReceivableTypes...>;
+#endif
 
     auto getMaxInboundMessageSize() const -> int;
     auto getReceiveBufferSize() const     -> int;
@@ -58,8 +112,13 @@ protected:
     ReceivingSocket(void* context, int type);
 
 private:
+    template <typename ReceivableType, typename... ReceivableTypes>
+    auto tryReceiveParts( const int flags
+                        , ReceivableType& receivable
+                        , ReceivableTypes&... receivables ) -> Result;
+
     // Terminating function for variadic member template.
-    auto receive() -> bool { return true; }
+    auto tryReceiveParts(const int) -> Result { return Result(); }
 };
 
 template <typename S>
@@ -77,31 +136,126 @@ ReceivingSocket<S>& ReceivingSocket<S>::operator=(ReceivingSocket<S>&& other)
     return (*this);
 }
 
+template <typename S>
+template <typename ReceivableType, typename... ReceivableTypes>
+inline
+auto ReceivingSocket<S>::receive( ReceivableType& receivable
+                                , ReceivableTypes&... receivables )
+    -> typename std::enable_if<IsReceivable<ReceivableType>::value, bool>::type
+{
+    return (checkResult(tryReceive(receivable, receivables...)));
+}
+
+template <typename S>
+template <typename ReceivableType, typename... ReceivableTypes>
+inline
+auto ReceivingSocket<S>::tryReceive( ReceivableType& receivable
+                                   , ReceivableTypes&... receivables )
+    -> typename std::enable_if<IsReceivable<ReceivableType>::value, Result>::type
+{
+    return (tryReceiveParts(0, receivable, receivables...));
+}
+
+template <typename S>
+template <typename ReceivableType, typename... ReceivableTypes>
+inline
+auto ReceivingSocket<S>::receive( const int flags
+                                , ReceivableType& receivable
+                                , ReceivableTypes&... receivables )
+    -> typename std::enable_if<IsReceivable<ReceivableType>::value, bool>::type
+{
+    return (checkResult(tryReceive(flags, receivable, receivables...)));
+}
+
+template <typename S>
+template <typename ReceivableType, typename... ReceivableTypes>
+inline
+auto ReceivingSocket<S>::tryReceive( const int flags
+                                   , ReceivableType& receivable
+                                   , ReceivableTypes&... receivables )
+    -> typename std::enable_if<IsReceivable<ReceivableType>::value, Result>::type
+{
+    return (tryReceiveParts(flags, receivable, receivables...));
+}
+
+template <typename S>
+template <typename Handler>
+inline
+auto ReceivingSocket<S>::drain( const size_t maxMessages
+                              , MultipartMessage& storage
+                              , Handler&& handler ) -> size_t
+{
+    size_t receivedCount = 0;
+
+    while (receivedCount < maxMessages &&
+           checkResult(tryReceive(ZMQ_DONTWAIT, storage)))
+    {
+        ++receivedCount;
+        handler(storage);
+    }
+
+    return receivedCount;
+}
+
+template <typename S>
+template <typename Iterator>
+inline
+auto ReceivingSocket<S>::drain(Iterator first, Iterator last) -> size_t
+{
+    size_t receivedCount = 0;
+
+    for (; first != last; ++first)
+    {
+        MultipartMessage& storage = *first;
+        if (!checkResult(tryReceive(ZMQ_DONTWAIT, storage)))
+        {
+            break;
+        }
+
+        ++receivedCount;
+    }
+
+    return receivedCount;
+}
+
+#if CPPEROMQ_HAS_COROUTINES
 template <typename S>
 template <typename... ReceivableTypes>
 inline
-auto ReceivingSocket<S>::receive( Receivable& receivable
-                                , ReceivableTypes&... receivables ) -> bool
+auto ReceivingSocket<S>::asyncReceive(ReceivableTypes&... receivables)
+    -> ReceiveAwaitable<ReceivingSocket<S>, ReceivableTypes...>
+{
+    return (ReceiveAwaitable<ReceivingSocket<S>, ReceivableTypes...>(*this, receivables...));
+}
+#endif
+
+template <typename S>
+template <typename ReceivableType, typename... ReceivableTypes>
+inline
+auto ReceivingSocket<S>::tryReceiveParts( const int flags
+                                        , ReceivableType& receivable
+                                        , ReceivableTypes&... receivables ) -> Result
 {
     bool moreToReceive = false;
-    if (!receivable.receive(*this, moreToReceive))
+    const Result result = receivable.tryReceive(*this, moreToReceive, flags);
+    if (!result)
     {
-        return false;
+        return result;
     }
 
     const size_t receivablesCount = sizeof...(receivables);
 
     if (!moreToReceive && (receivablesCount > 0))
     {
-        return false;
+        return (Result(EPROTO));
     }
 
     if (moreToReceive && (receivablesCount == 0))
     {
-        return false;
+        return (Result(EPROTO));
     }
 
-    return (receive(receivables...));
+    return (tryReceiveParts(flags, receivables...));
 }
 
 template <typename S>
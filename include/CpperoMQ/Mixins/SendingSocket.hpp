@@ -22,8 +22,13 @@
 
 #pragma once
 
+#include <CpperoMQ/Awaitable.hpp>
+#include <CpperoMQ/OutgoingMessage.hpp>
 #include <CpperoMQ/Sendable.hpp>
 
+#include <iterator>
+#include <type_traits>
+
 namespace CpperoMQ
 {
 namespace Mixins
@@ -40,8 +45,79 @@ public:
     SendingSocket& operator=(SendingSocket& other) = delete;
     SendingSocket& operator=(SendingSocket&& other);
 
+    // Each part may be a Sendable or a StaticSendable.  Parts are dispatched
+    // on their static type, so StaticSendable and final Sendable parts are
+    // sent without a virtual call.  Temporary OutgoingMessages are sent
+    // without a shallow copy.
+    template <typename SendableType, typename... SendableTypes>
+    auto send(SendableType&& sendable, SendableTypes&&... sendables) const
+        -> typename std::enable_if<IsSendable<SendableType>::value, bool>::type;
+
+    // Sends each Sendable in a range as one part of a single multipart
+    // message.  libzmq applies its high-water mark per message, so once the
+    // first part is queued the rest normally are too.  If a later part still
+    // fails, e.g. a composite Sendable that would block part-way, its error
+    // is reported without retrying and the message is left partially sent.
+    // OutgoingMessages reached through std::move_iterator are sent without a
+    // shallow copy.
+    template <typename Iterator>
+    auto send(Iterator first, Iterator last) const
+        -> typename std::enable_if<!IsSendable<Iterator>::value, bool>::type;
+
+    template <typename Container>
+    auto send(const Container& sendables) const
+        -> typename std::enable_if<!IsSendable<Container>::value, bool>::type;
+
+    // Non-throwing counterparts of the above, reporting the failing part's
+    // error number instead of throwing.  The send overloads are implemented
+    // in terms of these.
+    template <typename SendableType, typename... SendableTypes>
+    auto trySend(SendableType&& sendable, SendableTypes&&... sendables) const
+        -> typename std::enable_if<IsSendable<SendableType>::value, Result>::type;
+
+    template <typename Iterator>
+    auto trySend(Iterator first, Iterator last) const
+        -> typename std::enable_if<!IsSendable<Iterator>::value, Result>::type;
+
+    template <typename Container>
+    auto trySend(const Container& sendables) const
+        -> typename std::enable_if<!IsSendable<Container>::value, Result>::type;
+
+    // Sends with extra libzmq flags for this call only.  With ZMQ_DONTWAIT, a
+    // send that would block fails with EAGAIN instead, regardless of the
+    // socket's send timeout.
+    template <typename SendableType, typename... SendableTypes>
+    auto send(const int flags, SendableType&& sendable, SendableTypes&&... sendables) const
+        -> typename std::enable_if<IsSendable<SendableType>::value, bool>::type;
+
+    template <typename SendableType, typename... SendableTypes>
+    auto trySend(const int flags, SendableType&& sendable, SendableTypes&&... sendables) const
+        -> typename std::enable_if<IsSendable<SendableType>::value, Result>::type;
+
+    template <typename Iterator>
+    auto send(const int flags, Iterator first, Iterator last) const
+        -> typename std::enable_if<!IsSendable<Iterator>::value, bool>::type;
+
+    template <typename Iterator>
+    auto trySend(const int flags, Iterator first, Iterator last) const
+        -> typename std::enable_if<!IsSendable<Iterator>::value, Result>::type;
+
+    template <typename Container>
+    auto send(const int flags, const Container& sendables) const
+        -> typename std::enable_if<!IsSendable<Container>::value, bool>::type;
+
+    template <typename Container>
+    auto trySend(const int flags, const Container& sendables) const
+        -> typename std::enable_if<!IsSendable<Container>::value, Result>::type;
+
+#if CPPEROMQ_HAS_COROUTINES
+    // Sends from a coroutine run by a Scheduler, suspending it until the
+    // socket is writable if the send would block.  Temporary parts are moved
+    // into the returned awaitable; other parts must outlive it.
     template <typename... SendableTypes>
-    auto send(const Sendable& sendable, SendableTypes&&... sendables) const -> bool;
+    auto asyncSend(SendableTypes&&... sendables)
+        -> SendAwaitable<SendingSocket, SendableTypes...>;
+#endif
 
     auto getLingerPeriod() const      -> int;
     auto getMulticastHops() const     -> int;
@@ -59,8 +135,21 @@ protected:
     SendingSocket(void* context, int type);
 
 private:
+    template <typename SendableType, typename... SendableTypes>
+    auto trySendParts( const int flags
+                     , SendableType&& sendable
+                     , SendableTypes&&... sendables ) const -> Result;
+
     // Terminating function for variadic member template.
-    auto send() const -> bool { return true; }
+    auto trySendParts(const int) const -> Result { return Result(); }
+
+    template <typename SendableType>
+    auto trySendPart( const SendableType& sendable
+                    , const bool moreToSend
+                    , const int flags ) const -> Result;
+    auto trySendPart( OutgoingMessage&& message
+                    , const bool moreToSend
+                    , const int flags ) const -> Result;
 };
 
 template <typename S>
@@ -78,18 +167,196 @@ SendingSocket<S>& SendingSocket<S>::operator=(SendingSocket<S>&& other)
     return (*this);
 }
 
+template <typename S>
+template <typename SendableType, typename... SendableTypes>
+inline
+auto SendingSocket<S>::send( SendableType&& sendable
+                           , SendableTypes&&... sendables ) const
+    -> typename std::enable_if<IsSendable<SendableType>::value, bool>::type
+{
+    return (checkResult(trySend( std::forward<SendableType>(sendable)
+                               , std::forward<SendableTypes>(sendables)... )));
+}
+
+template <typename S>
+template <typename Iterator>
+inline
+auto SendingSocket<S>::send(Iterator first, Iterator last) const
+    -> typename std::enable_if<!IsSendable<Iterator>::value, bool>::type
+{
+    return (checkResult(trySend(first, last)));
+}
+
+template <typename S>
+template <typename Container>
+inline
+auto SendingSocket<S>::send(const Container& sendables) const
+    -> typename std::enable_if<!IsSendable<Container>::value, bool>::type
+{
+    return (checkResult(trySend(sendables)));
+}
+
+template <typename S>
+template <typename SendableType, typename... SendableTypes>
+inline
+auto SendingSocket<S>::trySend( SendableType&& sendable
+                              , SendableTypes&&... sendables ) const
+    -> typename std::enable_if<IsSendable<SendableType>::value, Result>::type
+{
+    return (trySendParts( 0
+                        , std::forward<SendableType>(sendable)
+                        , std::forward<SendableTypes>(sendables)... ));
+}
+
+template <typename S>
+template <typename Iterator>
+inline
+auto SendingSocket<S>::trySend(Iterator first, Iterator last) const
+    -> typename std::enable_if<!IsSendable<Iterator>::value, Result>::type
+{
+    return (trySend(0, first, last));
+}
+
+template <typename S>
+template <typename Container>
+inline
+auto SendingSocket<S>::trySend(const Container& sendables) const
+    -> typename std::enable_if<!IsSendable<Container>::value, Result>::type
+{
+    return (trySend(0, sendables));
+}
+
+template <typename S>
+template <typename SendableType, typename... SendableTypes>
+inline
+auto SendingSocket<S>::send( const int flags
+                           , SendableType&& sendable
+                           , SendableTypes&&... sendables ) const
+    -> typename std::enable_if<IsSendable<SendableType>::value, bool>::type
+{
+    return (checkResult(trySend( flags
+                               , std::forward<SendableType>(sendable)
+                               , std::forward<SendableTypes>(sendables)... )));
+}
+
+template <typename S>
+template <typename SendableType, typename... SendableTypes>
+inline
+auto SendingSocket<S>::trySend( const int flags
+                              , SendableType&& sendable
+                              , SendableTypes&&... sendables ) const
+    -> typename std::enable_if<IsSendable<SendableType>::value, Result>::type
+{
+    CPPEROMQ_ASSERT(0 == (flags & ZMQ_SNDMORE));
+
+    return (trySendParts( flags
+                        , std::forward<SendableType>(sendable)
+                        , std::forward<SendableTypes>(sendables)... ));
+}
+
+template <typename S>
+template <typename Iterator>
+inline
+auto SendingSocket<S>::send(const int flags, Iterator first, Iterator last) const
+    -> typename std::enable_if<!IsSendable<Iterator>::value, bool>::type
+{
+    return (checkResult(trySend(flags, first, last)));
+}
+
+template <typename S>
+template <typename Iterator>
+inline
+auto SendingSocket<S>::trySend(const int flags, Iterator first, Iterator last) const
+    -> typename std::enable_if<!IsSendable<Iterator>::value, Result>::type
+{
+    CPPEROMQ_ASSERT(0 == (flags & ZMQ_SNDMORE));
+
+    while (first != last)
+    {
+        // Forwarded as dereferenced, so that a range of move iterators
+        // releases its OutgoingMessages instead of copying them.
+        auto&& sendable = *first;
+        ++first;
+
+        const Result result = trySendPart( std::forward<decltype(sendable)>(sendable)
+                                         , (first != last)
+                                         , flags );
+        if (!result)
+        {
+            return result;
+        }
+    }
+
+    return (Result());
+}
+
+template <typename S>
+template <typename Container>
+inline
+auto SendingSocket<S>::send(const int flags, const Container& sendables) const
+    -> typename std::enable_if<!IsSendable<Container>::value, bool>::type
+{
+    return (checkResult(trySend(flags, sendables)));
+}
+
+template <typename S>
+template <typename Container>
+inline
+auto SendingSocket<S>::trySend(const int flags, const Container& sendables) const
+    -> typename std::enable_if<!IsSendable<Container>::value, Result>::type
+{
+    using std::begin;
+    using std::end;
+    return (trySend(flags, begin(sendables), end(sendables)));
+}
+
+#if CPPEROMQ_HAS_COROUTINES
 template <typename S>
 template <typename... SendableTypes>
 inline
-auto SendingSocket<S>::send( const Sendable& sendable
-                           , SendableTypes&&... sendables ) const -> bool
+auto SendingSocket<S>::asyncSend(SendableTypes&&... sendables)
+    -> SendAwaitable<SendingSocket<S>, SendableTypes...>
+{
+    return (SendAwaitable<SendingSocket<S>, SendableTypes...>( *this
+                                                              , std::forward<SendableTypes>(sendables)... ));
+}
+#endif
+
+template <typename S>
+template <typename SendableType, typename... SendableTypes>
+inline
+auto SendingSocket<S>::trySendParts( const int flags
+                                   , SendableType&& sendable
+                                   , SendableTypes&&... sendables ) const -> Result
 {
-    if (!sendable.send(*this, (sizeof...(sendables) > 0)))
+    const Result result = trySendPart( std::forward<SendableType>(sendable)
+                                     , (sizeof...(sendables) > 0)
+                                     , flags );
+    if (!result)
     {
-        return false;
+        return result;
     }
 
-    return (send(sendables...));
+    return (trySendParts(flags, std::forward<SendableTypes>(sendables)...));
+}
+
+template <typename S>
+template <typename SendableType>
+inline
+auto SendingSocket<S>::trySendPart( const SendableType& sendable
+                                  , const bool moreToSend
+                                  , const int flags ) const -> Result
+{
+    return (sendable.trySend(*this, moreToSend, flags));
+}
+
+template <typename S>
+inline
+auto SendingSocket<S>::trySendPart( OutgoingMessage&& message
+                                  , const bool moreToSend
+                                  , const int flags ) const -> Result
+{
+    return (message.trySendAndRelease(*this, moreToSend, flags));
 }
 
 template <typename S>
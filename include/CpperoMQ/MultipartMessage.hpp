@@ -0,0 +1,344 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/IncomingMessage.hpp>
+#include <CpperoMQ/Receivable.hpp>
+
+#include <array>
+#include <iterator>
+#include <new>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+// Receives every remaining frame of a multipart message, however many there
+// are.  The first InlineFrameCount frames live inside the object; frames
+// beyond that spill into a vector that is kept across receives, so a reused
+// MultipartMessage does not allocate once it has seen its largest message.
+class MultipartMessage final : public Receivable
+{
+public:
+    static const size_t InlineFrameCount = 8;
+
+    template <typename Owner, typename Frame>
+    class FrameIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = IncomingMessage;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Frame*;
+        using reference         = Frame&;
+
+        FrameIterator(Owner* owner, const size_t index);
+
+        auto operator*() const  -> reference;
+        auto operator->() const -> pointer;
+        auto operator++()       -> FrameIterator&;
+        auto operator++(int)    -> FrameIterator;
+        auto operator--()       -> FrameIterator&;
+        auto operator--(int)    -> FrameIterator;
+
+        auto operator==(const FrameIterator& other) const -> bool;
+        auto operator!=(const FrameIterator& other) const -> bool;
+
+    private:
+        Owner* mOwner;
+        size_t mIndex;
+    };
+
+    using iterator       = FrameIterator<MultipartMessage, IncomingMessage>;
+    using const_iterator = FrameIterator<const MultipartMessage, const IncomingMessage>;
+
+    MultipartMessage();
+    virtual ~MultipartMessage() = default;
+    MultipartMessage(const MultipartMessage& other) = delete;
+    MultipartMessage(MultipartMessage&& other);
+    MultipartMessage& operator=(const MultipartMessage& other) = delete;
+    MultipartMessage& operator=(MultipartMessage&& other);
+
+    auto size() const  -> size_t;
+    auto empty() const -> bool;
+    auto clear()       -> void;
+
+    auto operator[](const size_t index) const -> const IncomingMessage&;
+    auto operator[](const size_t index)       ->       IncomingMessage&;
+
+    auto begin() const -> const_iterator;
+    auto end() const   -> const_iterator;
+    auto begin()       -> iterator;
+    auto end()         -> iterator;
+
+    virtual auto receive(Socket& socket, bool& moreToReceive) -> bool override;
+    virtual auto tryReceive( Socket& socket
+                           , bool& moreToReceive
+                           , const int flags ) -> Result override;
+
+private:
+    auto getNextFrame() -> IncomingMessage&;
+    auto discardRemainingFrames(Socket& socket, bool& moreToReceive, const int flags) -> void;
+
+    std::array<IncomingMessage, InlineFrameCount> mInlineFrames;
+    std::vector<IncomingMessage> mOverflowFrames;
+    size_t mSize;
+};
+
+template <typename Owner, typename Frame>
+inline
+MultipartMessage::FrameIterator<Owner, Frame>::FrameIterator(Owner* owner, const size_t index)
+    : mOwner(owner)
+    , mIndex(index)
+{
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator*() const -> reference
+{
+    return ((*mOwner)[mIndex]);
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator->() const -> pointer
+{
+    return (&(*mOwner)[mIndex]);
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator++() -> FrameIterator&
+{
+    ++mIndex;
+    return (*this);
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator++(int) -> FrameIterator
+{
+    FrameIterator previous(*this);
+    ++mIndex;
+    return previous;
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator--() -> FrameIterator&
+{
+    --mIndex;
+    return (*this);
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator--(int) -> FrameIterator
+{
+    FrameIterator previous(*this);
+    --mIndex;
+    return previous;
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator==(const FrameIterator& other) const -> bool
+{
+    return (mOwner == other.mOwner && mIndex == other.mIndex);
+}
+
+template <typename Owner, typename Frame>
+inline
+auto MultipartMessage::FrameIterator<Owner, Frame>::operator!=(const FrameIterator& other) const -> bool
+{
+    return !(*this == other);
+}
+
+inline
+MultipartMessage::MultipartMessage()
+    : mInlineFrames()
+    , mOverflowFrames()
+    , mSize(0)
+{
+}
+
+inline
+MultipartMessage::MultipartMessage(MultipartMessage&& other)
+    : mInlineFrames(std::move(other.mInlineFrames))
+    , mOverflowFrames(std::move(other.mOverflowFrames))
+    , mSize(other.mSize)
+{
+    other.mSize = 0;
+}
+
+inline
+MultipartMessage& MultipartMessage::operator=(MultipartMessage&& other)
+{
+    using std::swap;
+    swap(mInlineFrames,   other.mInlineFrames);
+    swap(mOverflowFrames, other.mOverflowFrames);
+    swap(mSize,           other.mSize);
+    return (*this);
+}
+
+inline
+auto MultipartMessage::size() const -> size_t
+{
+    return mSize;
+}
+
+inline
+auto MultipartMessage::empty() const -> bool
+{
+    return (0 == mSize);
+}
+
+inline
+auto MultipartMessage::clear() -> void
+{
+    mSize = 0;
+}
+
+inline
+auto MultipartMessage::operator[](const size_t index) const -> const IncomingMessage&
+{
+    CPPEROMQ_ASSERT(index < mSize);
+    return (index < InlineFrameCount) ? mInlineFrames[index]
+                                      : mOverflowFrames[index - InlineFrameCount];
+}
+
+inline
+auto MultipartMessage::operator[](const size_t index) -> IncomingMessage&
+{
+    CPPEROMQ_ASSERT(index < mSize);
+    return (index < InlineFrameCount) ? mInlineFrames[index]
+                                      : mOverflowFrames[index - InlineFrameCount];
+}
+
+inline
+auto MultipartMessage::begin() const -> const_iterator
+{
+    return const_iterator(this, 0);
+}
+
+inline
+auto MultipartMessage::end() const -> const_iterator
+{
+    return const_iterator(this, mSize);
+}
+
+inline
+auto MultipartMessage::begin() -> iterator
+{
+    return iterator(this, 0);
+}
+
+inline
+auto MultipartMessage::end() -> iterator
+{
+    return iterator(this, mSize);
+}
+
+inline
+auto MultipartMessage::receive(Socket& socket, bool& moreToReceive) -> bool
+{
+    return (checkResult(tryReceive(socket, moreToReceive, 0)));
+}
+
+inline
+auto MultipartMessage::tryReceive( Socket& socket
+                                 , bool& moreToReceive
+                                 , const int flags ) -> Result
+{
+    mSize = 0;
+    moreToReceive = false;
+
+    Result result;
+
+    // Growing the overflow storage can throw part-way through a message,
+    // either Error from a new frame or bad_alloc from the vector.
+    try
+    {
+        do
+        {
+            result = getNextFrame().tryReceive(socket, moreToReceive, flags);
+            if (!result)
+            {
+                return result;
+            }
+
+            ++mSize;
+        }
+        while (moreToReceive);
+
+        return result;
+    }
+    catch (const Error& error)
+    {
+        result = Result(error.number());
+    }
+    catch (const std::bad_alloc&)
+    {
+        result = Result(ENOMEM);
+    }
+
+    // Drop the rest of the message so the next receive starts on a message
+    // boundary rather than part-way through this one.
+    discardRemainingFrames(socket, moreToReceive, flags);
+    mSize = 0;
+    return result;
+}
+
+inline
+auto MultipartMessage::getNextFrame() -> IncomingMessage&
+{
+    if (mSize < InlineFrameCount)
+    {
+        return mInlineFrames[mSize];
+    }
+
+    const size_t overflowIndex = mSize - InlineFrameCount;
+    if (overflowIndex == mOverflowFrames.size())
+    {
+        mOverflowFrames.emplace_back();
+    }
+
+    return mOverflowFrames[overflowIndex];
+}
+
+inline
+auto MultipartMessage::discardRemainingFrames( Socket& socket
+                                             , bool& moreToReceive
+                                             , const int flags ) -> void
+{
+    // The first inline frame is reused, so this cannot fail to allocate.
+    IncomingMessage& scratch = mInlineFrames[0];
+    while (moreToReceive && scratch.tryReceive(socket, moreToReceive, flags))
+    {
+    }
+
+    moreToReceive = false;
+}
+
+}
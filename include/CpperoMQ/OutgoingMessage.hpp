@@ -22,19 +22,44 @@
 
 #pragma once
 
+#include <CpperoMQ/IncomingMessage.hpp>
 #include <CpperoMQ/Message.hpp>
 #include <CpperoMQ/Sendable.hpp>
 #include <CpperoMQ/Socket.hpp>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace CpperoMQ
 {
 
 class OutgoingMessage final : public Message, public Sendable
 {
 public:
+    using FreeFunction = zmq_free_fn*;
+
     OutgoingMessage(const size_t size, const void* sourceData);
     OutgoingMessage(const size_t size, const char* sourceData);
     OutgoingMessage(const char* sourceData);
+
+    // Zero-copy: 'data' is handed to libzmq as-is.  'freeFunction' is called
+    // (possibly from a libzmq I/O thread) once libzmq no longer needs the
+    // data.  A null 'freeFunction' means the caller keeps the data alive for
+    // the lifetime of the message and all of its copies.
+    OutgoingMessage( const size_t size
+                   , void* data
+                   , FreeFunction freeFunction
+                   , void* hint = nullptr );
+    explicit OutgoingMessage(std::string&& sourceData);
+    explicit OutgoingMessage(std::vector<char>&& sourceData);
+
+    // Forwards a received frame without copying its data.  The rvalue
+    // overload takes the frame over, leaving 'message' empty; the const
+    // overload shares it through libzmq's reference count.
+    explicit OutgoingMessage(IncomingMessage&& message);
+    explicit OutgoingMessage(const IncomingMessage& message);
+
     OutgoingMessage(); // for empty frames
     virtual ~OutgoingMessage() = default;
     OutgoingMessage(const OutgoingMessage& other) = delete;
@@ -42,7 +67,30 @@ public:
     OutgoingMessage& operator=(const OutgoingMessage& other) = delete;
     OutgoingMessage& operator=(OutgoingMessage&& other);
 
+    // Read-only access, e.g. for inspecting frames before they are sent.
+    auto size() const -> size_t;
+    auto data() const -> const void*;
+    auto charData() const -> const char*;
+
     virtual auto send(const Socket& socket, const bool moreToSend) const -> bool override;
+    virtual auto trySend( const Socket& socket
+                        , const bool moreToSend
+                        , const int flags ) const NOEXCEPT -> Result override;
+
+    // One-shot send that hands the message itself to libzmq instead of a
+    // shallow copy.  The message is left empty on success and untouched on
+    // failure, so the send can be retried.
+    auto sendAndRelease(const Socket& socket, const bool moreToSend) -> bool;
+    auto trySendAndRelease( const Socket& socket
+                          , const bool moreToSend
+                          , const int flags ) NOEXCEPT -> Result;
+
+private:
+    template <typename Container>
+    explicit OutgoingMessage(std::unique_ptr<Container>&& container);
+
+    template <typename Container>
+    static auto releaseContainer(void* data, void* hint) -> void;
 };
 
 inline
@@ -63,6 +111,40 @@ OutgoingMessage::OutgoingMessage(const char* sourceData)
 {
 }
 
+inline
+OutgoingMessage::OutgoingMessage( const size_t size
+                                , void* data
+                                , FreeFunction freeFunction
+                                , void* hint )
+    : Message(size, data, freeFunction, hint)
+{
+}
+
+inline
+OutgoingMessage::OutgoingMessage(std::string&& sourceData)
+    : OutgoingMessage(std::unique_ptr<std::string>(new std::string(std::move(sourceData))))
+{
+}
+
+inline
+OutgoingMessage::OutgoingMessage(std::vector<char>&& sourceData)
+    : OutgoingMessage(std::unique_ptr<std::vector<char>>(new std::vector<char>(std::move(sourceData))))
+{
+}
+
+inline
+OutgoingMessage::OutgoingMessage(IncomingMessage&& message)
+    : Message(std::move(message))
+{
+}
+
+inline
+OutgoingMessage::OutgoingMessage(const IncomingMessage& message)
+    : Message()
+{
+    message.shallowCopy(*this);
+}
+
 inline
 OutgoingMessage::OutgoingMessage()
     : Message()
@@ -82,32 +164,107 @@ OutgoingMessage& OutgoingMessage::operator=(OutgoingMessage&& other)
     return (*this);
 }
 
+inline
+auto OutgoingMessage::size() const -> size_t
+{
+    const zmq_msg_t* const msgPtr = getInternalMessage();
+    CPPEROMQ_ASSERT(nullptr != msgPtr);
+    return (zmq_msg_size(const_cast<zmq_msg_t*>(msgPtr)));
+}
+
+inline
+auto OutgoingMessage::data() const -> const void*
+{
+    const zmq_msg_t* const msgPtr = getInternalMessage();
+    CPPEROMQ_ASSERT(nullptr != msgPtr);
+    return (zmq_msg_data(const_cast<zmq_msg_t*>(msgPtr)));
+}
+
+inline
+auto OutgoingMessage::charData() const -> const char*
+{
+    return (static_cast<const char*>(data()));
+}
+
 inline
 auto OutgoingMessage::send(const Socket& socket, const bool moreToSend) const -> bool
+{
+    return (checkResult(trySend(socket, moreToSend, 0)));
+}
+
+inline
+auto OutgoingMessage::trySend( const Socket& socket
+                             , const bool moreToSend
+                             , const int flags ) const NOEXCEPT -> Result
 {
     zmq_msg_t* msgPtr = const_cast<zmq_msg_t*>(getInternalMessage());
 
     CPPEROMQ_ASSERT(nullptr != msgPtr);
     CPPEROMQ_ASSERT(nullptr != socket.mSocket);
 
-    OutgoingMessage message;
-    shallowCopy(message);
-    msgPtr = message.getInternalMessage();
-
-    CPPEROMQ_ASSERT(nullptr != msgPtr);
+    // A raw zmq_msg_t rather than an OutgoingMessage, whose constructor
+    // throws.
+    zmq_msg_t copy;
+    if (0 != zmq_msg_init(&copy))
+    {
+        return (Result::fromErrno());
+    }
 
-    const int flags = (moreToSend) ? ZMQ_SNDMORE : 0;
-    if (zmq_msg_send(msgPtr, socket.mSocket, flags) >= 0)
+    const int sendFlags = ((moreToSend) ? ZMQ_SNDMORE : 0) | flags;
+    if (0 == zmq_msg_copy(&copy, msgPtr) &&
+        zmq_msg_send(&copy, socket.mSocket, sendFlags) >= 0)
     {
-        return true;
+        return (Result());
     }
 
-    if (zmq_errno() == EAGAIN)
+    const Result result = Result::fromErrno();
+    zmq_msg_close(&copy);
+    return result;
+}
+
+inline
+auto OutgoingMessage::sendAndRelease(const Socket& socket, const bool moreToSend) -> bool
+{
+    return (checkResult(trySendAndRelease(socket, moreToSend, 0)));
+}
+
+inline
+auto OutgoingMessage::trySendAndRelease( const Socket& socket
+                                       , const bool moreToSend
+                                       , const int flags ) NOEXCEPT -> Result
+{
+    zmq_msg_t* msgPtr = getInternalMessage();
+
+    CPPEROMQ_ASSERT(nullptr != msgPtr);
+    CPPEROMQ_ASSERT(nullptr != socket.mSocket);
+
+    const int sendFlags = ((moreToSend) ? ZMQ_SNDMORE : 0) | flags;
+    if (zmq_msg_send(msgPtr, socket.mSocket, sendFlags) >= 0)
     {
-        return false;
+        return (Result());
     }
 
-    throw Error();
+    return (Result::fromErrno());
+}
+
+template <typename Container>
+inline
+OutgoingMessage::OutgoingMessage(std::unique_ptr<Container>&& container)
+    : Message( container->size()
+             , const_cast<char*>(container->data())
+             , &OutgoingMessage::releaseContainer<Container>
+             , container.get() )
+{
+    // libzmq owns the container from here on.
+    container.release();
+}
+
+template <typename Container>
+inline
+auto OutgoingMessage::releaseContainer(void* data, void* hint) -> void
+{
+    (void)data;
+    delete static_cast<Container*>(hint);
 }
 
 }
@@ -42,6 +42,8 @@ class PollItem
 public:
     using Callback = std::function<void(void)>;
 
+    using FileDescriptor = Socket::FileDescriptor;
+
     virtual ~PollItem() = default;
     PollItem(const PollItem& other) = delete;
     PollItem(PollItem&& other);
@@ -53,39 +55,54 @@ public:
     auto getRawSocket() const -> const void*;
     auto getRawSocket()       ->       void*;
 
+    auto getSocket() const -> Socket*;
+
+    // Only meaningful for items without a socket.
+    auto getFileDescriptor() const -> FileDescriptor;
+
     auto getCallback() -> Callback;
 
 protected:
     PollItem(int events, Socket& socket, Callback callable = Callback());
+    PollItem(int events, FileDescriptor fileDescriptor, Callback callable = Callback());
 
 private:
-    PollItem(int events, Socket* socket, Callback callable = Callback());
+    PollItem(int events, Socket* socket, FileDescriptor fileDescriptor, Callback callable);
 
     int mEvents;
     Socket* mSocketPtr;
+    FileDescriptor mFileDescriptor;
     Callback mCallable;
 };
 
 inline
 PollItem::PollItem(PollItem&& other)
-    : PollItem(0, nullptr, Callback())
+    : PollItem(0, nullptr, FileDescriptor(), Callback())
 {
     using std::swap;
-    swap(mEvents,    other.mEvents);
-    swap(mSocketPtr, other.mSocketPtr);
-    swap(mCallable,  other.mCallable);
+    swap(mEvents,         other.mEvents);
+    swap(mSocketPtr,      other.mSocketPtr);
+    swap(mFileDescriptor, other.mFileDescriptor);
+    swap(mCallable,       other.mCallable);
 }
 
 inline
 PollItem::PollItem(int events, Socket& socket, Callback callable)
-    : PollItem(events, &socket, callable)
+    : PollItem(events, &socket, FileDescriptor(), callable)
+{
+}
+
+inline
+PollItem::PollItem(int events, FileDescriptor fileDescriptor, Callback callable)
+    : PollItem(events, nullptr, fileDescriptor, callable)
 {
 }
 
 inline
-PollItem::PollItem(int events, Socket* socket, Callback callable)
+PollItem::PollItem(int events, Socket* socket, FileDescriptor fileDescriptor, Callback callable)
     : mEvents(events)
     , mSocketPtr(socket)
+    , mFileDescriptor(fileDescriptor)
     , mCallable(callable)
 {
 }
@@ -108,6 +125,18 @@ auto PollItem::getRawSocket() -> void*
     return (mSocketPtr) ? static_cast<void*>(*mSocketPtr) : nullptr;
 }
 
+inline
+auto PollItem::getSocket() const -> Socket*
+{
+    return mSocketPtr;
+}
+
+inline
+auto PollItem::getFileDescriptor() const -> FileDescriptor
+{
+    return mFileDescriptor;
+}
+
 inline
 auto PollItem::getCallback() -> PollItem::Callback
 {
@@ -219,6 +248,32 @@ IsSendOrReceiveReady<S>::IsSendOrReceiveReady(IsSendOrReceiveReady&& other)
 {
 }
 
+// Polls a plain file descriptor (e.g. a timerfd, an eventfd or a TCP socket)
+// alongside 0MQ sockets.  'events' is any combination of ZMQ_POLLIN,
+// ZMQ_POLLOUT and ZMQ_POLLERR.
+class IsFileDescriptorReady : public PollItem
+{
+public:
+    IsFileDescriptorReady(FileDescriptor fileDescriptor, int events, Callback callable = Callback());
+    virtual ~IsFileDescriptorReady() = default;
+    IsFileDescriptorReady(const IsFileDescriptorReady& other) = delete;
+    IsFileDescriptorReady(IsFileDescriptorReady&& other);
+    IsFileDescriptorReady& operator=(const IsFileDescriptorReady& other) = delete;
+    IsFileDescriptorReady& operator=(IsFileDescriptorReady&& other) = delete;
+};
+
+inline
+IsFileDescriptorReady::IsFileDescriptorReady(FileDescriptor fileDescriptor, int events, Callback callable)
+    : PollItem(events, fileDescriptor, callable)
+{
+}
+
+inline
+IsFileDescriptorReady::IsFileDescriptorReady(IsFileDescriptorReady&& other)
+    : PollItem(std::move(other))
+{
+}
+
 template <typename S>
 inline
 auto isReceiveReady(S& socket, PollItem::Callback callable = PollItem::Callback()) -> IsReceiveReady<S>
@@ -243,4 +298,13 @@ auto isSendOrReceiveReady(S& socket, PollItem::Callback callable = PollItem::Cal
     return (sendOrReceiveReady);
 }
 
+inline
+auto isFileDescriptorReady( PollItem::FileDescriptor fileDescriptor
+                          , int events
+                          , PollItem::Callback callable = PollItem::Callback() ) -> IsFileDescriptorReady
+{
+    IsFileDescriptorReady fileDescriptorReady(fileDescriptor, events, callable);
+    return (fileDescriptorReady);
+}
+
 }
@@ -23,24 +23,159 @@
 #pragma once
 
 #include <CpperoMQ/PollItem.hpp>
+#include <CpperoMQ/Span.hpp>
+#include <CpperoMQ/TimerWheel.hpp>
 
+#include <algorithm>
 #include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// The zmq_poller API is O(1) per registration and waits on epoll (or the
+// platform equivalent), but is only available in draft builds of libzmq.
+#if defined(ZMQ_BUILD_DRAFT_API) && ZMQ_VERSION >= ZMQ_MAKE_VERSION(4, 2, 0)
+#define CPPEROMQ_HAS_ZMQ_POLLER 1
+#else
+#define CPPEROMQ_HAS_ZMQ_POLLER 0
+#endif
 
 namespace CpperoMQ
 {
 
+// Items can either be passed to each call of the variadic poll, or
+// registered once with add and then polled any number of times with the
+// no-argument poll.  Registered items are kept between polls, so each such
+// poll is just a wait plus dispatch.  The wait uses zmq_poller where libzmq
+// provides it and falls back to zmq_poll otherwise.
+//
+// Instead of dispatching to callbacks, wait returns the ready items along
+// with the events that fired, so work can be scheduled across them.
+//
+// Timers added to the Poller's TimerWheel shorten the timeout of each wait to
+// the next due timer, and fire once the I/O of that wait has been handled.
+// wait() returns before the caller handles the I/O, so timers due by then
+// fire at the start of the next wait or poll instead.
 class Poller
 {
+    struct Registration;
+
 public:
+    class ReadyItem final
+    {
+        friend class Poller;
+
+    public:
+        // The socket is null for file descriptor items.
+        auto getSocket() const         -> Socket*;
+        auto getFileDescriptor() const -> PollItem::FileDescriptor;
+        auto getEvents() const         -> int;
+
+        auto isReceiveReady() const -> bool;
+        auto isSendReady() const    -> bool;
+        auto hasError() const       -> bool;
+
+    private:
+        Registration* mRegistration;
+        Socket* mSocket;
+        PollItem::FileDescriptor mFileDescriptor;
+        short mEvents;
+    };
+
     Poller(const long timeout = -1);
+    ~Poller();
+    Poller(const Poller& other) = delete;
+    Poller(Poller&& other);
+    Poller& operator=(const Poller& other) = delete;
+    Poller& operator=(Poller&& other);
 
     auto getTimeout() const -> long;
     auto setTimeout(const long timeout) -> void;
 
+    auto getTimerWheel() -> TimerWheel&;
+
     template <typename... PollItemTypes>
     auto poll(PollItem& pollItem, PollItemTypes&... pollItems) -> void;
 
+    // Registration of items polled by the no-argument poll.  A socket or file
+    // descriptor may be registered once; modify replaces its events and
+    // callback.  Changes made from within a callback take effect once the
+    // current dispatch is done, except that a removed item is not dispatched
+    // again.  Adding a socket twice, or modifying or removing one that is not
+    // registered, throws an Error with EINVAL straight away, counting changes
+    // that are still deferred.
+    auto add(PollItem&& pollItem)    -> void;
+    auto modify(PollItem&& pollItem) -> void;
+    auto remove(Socket& socket)      -> void;
+    auto remove(PollItem::FileDescriptor fileDescriptor) -> void;
+
+    // With nothing registered and no timer pending, an infinite wait could
+    // never end, so it returns at once with no ready items.
+    auto poll() -> void;
+
+    // Waits for registered items without calling their callbacks.  The ready
+    // items remain valid until the next wait or poll, which first fires the
+    // timers that were due when this one returned.
+    auto wait() -> Span<const ReadyItem>;
+
+    // Waits, then calls 'handler' with each ready item (as a const
+    // ReadyItem&).  The handler is called directly, not through a
+    // std::function.  Returns the number of ready items.
+    template <typename Handler>
+    auto wait(Handler&& handler) -> size_t;
+
 private:
+    class DispatchScope final
+    {
+    public:
+        explicit DispatchScope(Poller& poller);
+        ~DispatchScope();
+        DispatchScope(const DispatchScope& other) = delete;
+        DispatchScope& operator=(const DispatchScope& other) = delete;
+
+    private:
+        Poller& mPoller;
+    };
+
+    // Heap-allocated so that its address can be handed to zmq_poller as user
+    // data and stays valid while other items are added and removed.
+    struct Registration
+    {
+        zmq_pollitem_t item;
+        Socket* socket;
+        PollItem::Callback callback;
+        size_t index;
+        bool isRemoved;
+    };
+
+    struct DeferredChange
+    {
+        enum class Kind { Add, Modify, Remove };
+
+        Kind kind;
+        zmq_pollitem_t item;
+        Socket* socket;
+        PollItem::Callback callback;
+    };
+
+    auto addItem( const zmq_pollitem_t& item
+                , Socket* socket
+                , PollItem::Callback&& callback ) -> void;
+    auto modifyItem( const zmq_pollitem_t& item
+                   , Socket* socket
+                   , PollItem::Callback&& callback ) -> void;
+    auto removeItem(const zmq_pollitem_t& item)                   -> void;
+    auto removeOrDefer(const zmq_pollitem_t& item, Socket* socket) -> void;
+    auto findRegistration(const zmq_pollitem_t& item) const       -> Registration*;
+    auto willBeRegistered(const zmq_pollitem_t& item) const       -> bool;
+    auto applyDeferredChanges()                     -> void;
+    auto waitForEvents()                            -> void;
+    auto advancePendingTimers()                     -> void;
+    auto addReadyItem(Registration* registration, const short events) -> void;
+    auto getWaitTimeout() const -> long;
+
+    static auto makeItem(PollItem& pollItem) -> zmq_pollitem_t;
+
     template <size_t N, typename... PollItemTypes>
     auto poll( std::array<zmq_pollitem_t, N>& pollItemArray
              , std::array<PollItem::Callback, N>& callbackArray
@@ -52,12 +187,106 @@ private:
              , std::array<PollItem::Callback, N>& callbackArray ) -> void;
 
     long mTimeout;
+    TimerWheel mTimerWheel;
+    std::vector<std::unique_ptr<Registration>> mRegistrations;
+    std::unordered_map<const void*, Registration*> mRegistrationsBySocket;
+    std::unordered_map<PollItem::FileDescriptor, Registration*> mRegistrationsByFileDescriptor;
+    std::vector<ReadyItem> mReadyItems;
+    std::vector<DeferredChange> mDeferredChanges;
+    bool mIsDispatching;
+    bool mIsTimerAdvancePending;
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    void* mPoller;
+    std::vector<zmq_poller_event_t> mPollerEvents;
+#else
+    std::vector<zmq_pollitem_t> mItems;
+#endif
 };
 
 inline
 Poller::Poller(const long timeout)
     : mTimeout(timeout)
+    , mTimerWheel()
+    , mRegistrations()
+    , mRegistrationsBySocket()
+    , mRegistrationsByFileDescriptor()
+    , mReadyItems()
+    , mDeferredChanges()
+    , mIsDispatching(false)
+    , mIsTimerAdvancePending(false)
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    , mPoller(nullptr)
+    , mPollerEvents()
+#else
+    , mItems()
+#endif
+{
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    mPoller = zmq_poller_new();
+    if (nullptr == mPoller)
+    {
+        throw Error();
+    }
+#endif
+}
+
+inline
+Poller::~Poller()
 {
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    if (nullptr != mPoller)
+    {
+        int result = zmq_poller_destroy(&mPoller);
+        CPPEROMQ_ASSERT(0 == result);
+    }
+#endif
+}
+
+inline
+Poller::Poller(Poller&& other)
+    : mTimeout(other.mTimeout)
+    , mTimerWheel(std::move(other.mTimerWheel))
+    , mRegistrations(std::move(other.mRegistrations))
+    , mRegistrationsBySocket(std::move(other.mRegistrationsBySocket))
+    , mRegistrationsByFileDescriptor(std::move(other.mRegistrationsByFileDescriptor))
+    , mReadyItems()
+    , mDeferredChanges(std::move(other.mDeferredChanges))
+    , mIsDispatching(false)
+    , mIsTimerAdvancePending(other.mIsTimerAdvancePending)
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    , mPoller(other.mPoller)
+    , mPollerEvents(std::move(other.mPollerEvents))
+#else
+    , mItems(std::move(other.mItems))
+#endif
+{
+    CPPEROMQ_ASSERT(!other.mIsDispatching);
+
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    other.mPoller = nullptr;
+#endif
+}
+
+inline
+Poller& Poller::operator=(Poller&& other)
+{
+    CPPEROMQ_ASSERT(!mIsDispatching && !other.mIsDispatching);
+
+    using std::swap;
+    swap(mTimeout,                       other.mTimeout);
+    swap(mTimerWheel,                    other.mTimerWheel);
+    swap(mRegistrations,                 other.mRegistrations);
+    swap(mRegistrationsBySocket,         other.mRegistrationsBySocket);
+    swap(mRegistrationsByFileDescriptor, other.mRegistrationsByFileDescriptor);
+    swap(mDeferredChanges,               other.mDeferredChanges);
+    swap(mIsTimerAdvancePending,         other.mIsTimerAdvancePending);
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    swap(mPoller,                        other.mPoller);
+    swap(mPollerEvents,                  other.mPollerEvents);
+#else
+    swap(mItems,                         other.mItems);
+#endif
+    return (*this);
 }
 
 inline
@@ -72,6 +301,12 @@ auto Poller::setTimeout(const long timeout) -> void
     mTimeout = timeout;
 }
 
+inline
+auto Poller::getTimerWheel() -> TimerWheel&
+{
+    return mTimerWheel;
+}
+
 template <typename... PollItemTypes>
 inline
 auto Poller::poll(PollItem& pollItem, PollItemTypes&... pollItems) -> void
@@ -82,6 +317,479 @@ auto Poller::poll(PollItem& pollItem, PollItemTypes&... pollItems) -> void
     poll(pollItemArray, callbackArray, pollItem, pollItems...);
 }
 
+inline
+auto Poller::add(PollItem&& pollItem) -> void
+{
+    const zmq_pollitem_t item = makeItem(pollItem);
+    if (mIsDispatching)
+    {
+        if (willBeRegistered(item))
+        {
+            throw Error(EINVAL);
+        }
+
+        DeferredChange change = { DeferredChange::Kind::Add, item, pollItem.getSocket(), pollItem.getCallback() };
+        mDeferredChanges.push_back(std::move(change));
+        return;
+    }
+
+    addItem(item, pollItem.getSocket(), pollItem.getCallback());
+}
+
+inline
+auto Poller::modify(PollItem&& pollItem) -> void
+{
+    const zmq_pollitem_t item = makeItem(pollItem);
+    if (mIsDispatching)
+    {
+        if (!willBeRegistered(item))
+        {
+            throw Error(EINVAL);
+        }
+
+        DeferredChange change = { DeferredChange::Kind::Modify, item, pollItem.getSocket(), pollItem.getCallback() };
+        mDeferredChanges.push_back(std::move(change));
+        return;
+    }
+
+    modifyItem(item, pollItem.getSocket(), pollItem.getCallback());
+}
+
+inline
+auto Poller::remove(Socket& socket) -> void
+{
+    zmq_pollitem_t item = { static_cast<void*>(socket), PollItem::FileDescriptor(), 0, 0 };
+    removeOrDefer(item, &socket);
+}
+
+inline
+auto Poller::remove(PollItem::FileDescriptor fileDescriptor) -> void
+{
+    zmq_pollitem_t item = { nullptr, fileDescriptor, 0, 0 };
+    removeOrDefer(item, nullptr);
+}
+
+inline
+auto Poller::poll() -> void
+{
+    advancePendingTimers();
+    waitForEvents();
+
+    // Callbacks may change the registration, which is deferred until the
+    // dispatch is done so that no registration is destroyed while in use.
+    {
+        DispatchScope dispatchScope(*this);
+
+        for (const ReadyItem& readyItem : mReadyItems)
+        {
+            Registration& registration = *readyItem.mRegistration;
+            if (!registration.isRemoved &&
+                registration.callback &&
+                (readyItem.mEvents & (ZMQ_POLLIN | ZMQ_POLLOUT | ZMQ_POLLERR)))
+            {
+                registration.callback();
+            }
+        }
+    }
+
+    applyDeferredChanges();
+    mTimerWheel.advance();
+}
+
+inline
+auto Poller::wait() -> Span<const ReadyItem>
+{
+    advancePendingTimers();
+    waitForEvents();
+
+    // The caller handles the ready items after this returns, so timers must
+    // not fire until then.
+    mIsTimerAdvancePending = true;
+    return Span<const ReadyItem>(mReadyItems.data(), mReadyItems.size());
+}
+
+template <typename Handler>
+inline
+auto Poller::wait(Handler&& handler) -> size_t
+{
+    advancePendingTimers();
+    waitForEvents();
+
+    // As in poll, so that an item removed by the handler is not handed to it
+    // later in this cycle.
+    {
+        DispatchScope dispatchScope(*this);
+
+        for (const ReadyItem& readyItem : mReadyItems)
+        {
+            if (!readyItem.mRegistration->isRemoved)
+            {
+                handler(readyItem);
+            }
+        }
+    }
+
+    applyDeferredChanges();
+    mTimerWheel.advance();
+    return mReadyItems.size();
+}
+
+inline
+auto Poller::ReadyItem::getSocket() const -> Socket*
+{
+    return mSocket;
+}
+
+inline
+auto Poller::ReadyItem::getFileDescriptor() const -> PollItem::FileDescriptor
+{
+    return mFileDescriptor;
+}
+
+inline
+auto Poller::ReadyItem::getEvents() const -> int
+{
+    return mEvents;
+}
+
+inline
+auto Poller::ReadyItem::isReceiveReady() const -> bool
+{
+    return (0 != (mEvents & ZMQ_POLLIN));
+}
+
+inline
+auto Poller::ReadyItem::isSendReady() const -> bool
+{
+    return (0 != (mEvents & ZMQ_POLLOUT));
+}
+
+inline
+auto Poller::ReadyItem::hasError() const -> bool
+{
+    return (0 != (mEvents & ZMQ_POLLERR));
+}
+
+inline
+Poller::DispatchScope::DispatchScope(Poller& poller)
+    : mPoller(poller)
+{
+    mPoller.mIsDispatching = true;
+}
+
+inline
+Poller::DispatchScope::~DispatchScope()
+{
+    mPoller.mIsDispatching = false;
+}
+
+inline
+auto Poller::addItem( const zmq_pollitem_t& item
+                    , Socket* socket
+                    , PollItem::Callback&& callback ) -> void
+{
+    if (nullptr != findRegistration(item))
+    {
+        throw Error(EINVAL);
+    }
+
+    std::unique_ptr<Registration> registration(new Registration());
+    registration->item      = item;
+    registration->socket    = socket;
+    registration->callback  = std::move(callback);
+    registration->index     = mRegistrations.size();
+    registration->isRemoved = false;
+
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    const int result = (nullptr != item.socket)
+                     ? zmq_poller_add(mPoller, item.socket, registration.get(), item.events)
+                     : zmq_poller_add_fd(mPoller, item.fd, registration.get(), item.events);
+    if (0 != result)
+    {
+        throw Error();
+    }
+
+    mPollerEvents.resize(mRegistrations.size() + 1);
+#else
+    mItems.push_back(item);
+#endif
+
+    if (nullptr != item.socket)
+    {
+        mRegistrationsBySocket[item.socket] = registration.get();
+    }
+    else
+    {
+        mRegistrationsByFileDescriptor[item.fd] = registration.get();
+    }
+
+    mRegistrations.push_back(std::move(registration));
+}
+
+inline
+auto Poller::modifyItem( const zmq_pollitem_t& item
+                       , Socket* socket
+                       , PollItem::Callback&& callback ) -> void
+{
+    Registration* registration = findRegistration(item);
+    if (nullptr == registration)
+    {
+        throw Error(EINVAL);
+    }
+
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    const int result = (nullptr != item.socket)
+                     ? zmq_poller_modify(mPoller, item.socket, item.events)
+                     : zmq_poller_modify_fd(mPoller, item.fd, item.events);
+    if (0 != result)
+    {
+        throw Error();
+    }
+#else
+    mItems[registration->index] = item;
+#endif
+
+    registration->item     = item;
+    registration->socket   = socket;
+    registration->callback = std::move(callback);
+}
+
+inline
+auto Poller::removeItem(const zmq_pollitem_t& item) -> void
+{
+    Registration* registration = findRegistration(item);
+    if (nullptr == registration)
+    {
+        throw Error(EINVAL);
+    }
+
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    const int result = (nullptr != item.socket)
+                     ? zmq_poller_remove(mPoller, item.socket)
+                     : zmq_poller_remove_fd(mPoller, item.fd);
+    if (0 != result)
+    {
+        throw Error();
+    }
+#endif
+
+    // Move the last registration into the vacated slot.
+    const size_t index = registration->index;
+    const size_t lastIndex = mRegistrations.size() - 1;
+    if (index != lastIndex)
+    {
+        mRegistrations[index] = std::move(mRegistrations[lastIndex]);
+        mRegistrations[index]->index = index;
+#if !CPPEROMQ_HAS_ZMQ_POLLER
+        mItems[index] = mItems[lastIndex];
+#endif
+    }
+
+    if (nullptr != item.socket)
+    {
+        mRegistrationsBySocket.erase(item.socket);
+    }
+    else
+    {
+        mRegistrationsByFileDescriptor.erase(item.fd);
+    }
+
+    mRegistrations.pop_back();
+#if !CPPEROMQ_HAS_ZMQ_POLLER
+    mItems.pop_back();
+#endif
+}
+
+inline
+auto Poller::removeOrDefer(const zmq_pollitem_t& item, Socket* socket) -> void
+{
+    if (mIsDispatching)
+    {
+        if (!willBeRegistered(item))
+        {
+            throw Error(EINVAL);
+        }
+
+        // Keep the item from being dispatched later in this cycle.
+        Registration* registration = findRegistration(item);
+        if (nullptr != registration)
+        {
+            registration->isRemoved = true;
+        }
+
+        DeferredChange change = { DeferredChange::Kind::Remove, item, socket, PollItem::Callback() };
+        mDeferredChanges.push_back(std::move(change));
+        return;
+    }
+
+    removeItem(item);
+}
+
+inline
+auto Poller::findRegistration(const zmq_pollitem_t& item) const -> Registration*
+{
+    if (nullptr != item.socket)
+    {
+        const auto found = mRegistrationsBySocket.find(item.socket);
+        return (found != mRegistrationsBySocket.end()) ? found->second : nullptr;
+    }
+
+    const auto found = mRegistrationsByFileDescriptor.find(item.fd);
+    return (found != mRegistrationsByFileDescriptor.end()) ? found->second : nullptr;
+}
+
+inline
+auto Poller::willBeRegistered(const zmq_pollitem_t& item) const -> bool
+{
+    // Replays the deferred changes, so that each can be validated when it is
+    // made rather than part way through applying them.
+    bool isRegistered = (nullptr != findRegistration(item));
+
+    for (const DeferredChange& change : mDeferredChanges)
+    {
+        const bool isSameItem = (nullptr != item.socket)
+                              ? (change.item.socket == item.socket)
+                              : (nullptr == change.item.socket && change.item.fd == item.fd);
+        if (isSameItem)
+        {
+            if (DeferredChange::Kind::Add == change.kind)
+            {
+                isRegistered = true;
+            }
+            else if (DeferredChange::Kind::Remove == change.kind)
+            {
+                isRegistered = false;
+            }
+        }
+    }
+
+    return isRegistered;
+}
+
+inline
+auto Poller::applyDeferredChanges() -> void
+{
+    std::vector<DeferredChange> changes;
+    changes.swap(mDeferredChanges);
+
+    for (DeferredChange& change : changes)
+    {
+        switch (change.kind)
+        {
+        case DeferredChange::Kind::Add:
+            addItem(change.item, change.socket, std::move(change.callback));
+            break;
+        case DeferredChange::Kind::Modify:
+            modifyItem(change.item, change.socket, std::move(change.callback));
+            break;
+        case DeferredChange::Kind::Remove:
+            removeItem(change.item);
+            break;
+        }
+    }
+}
+
+inline
+auto Poller::waitForEvents() -> void
+{
+    mReadyItems.clear();
+
+    // Nothing could end such a wait; zmq_poller_wait_all fails it with
+    // EFAULT.
+    const long timeout = getWaitTimeout();
+    if (mRegistrations.empty() && timeout < 0)
+    {
+        return;
+    }
+
+#if CPPEROMQ_HAS_ZMQ_POLLER
+    if (mPollerEvents.empty())
+    {
+        // zmq_poller_wait_all rejects a null event array even when there is
+        // nothing to wait on.
+        mPollerEvents.resize(1);
+    }
+
+    const int eventCount = zmq_poller_wait_all( mPoller
+                                              , mPollerEvents.data()
+                                              , static_cast<int>(mRegistrations.size())
+                                              , timeout );
+    if (eventCount < 0)
+    {
+        // Unlike zmq_poll, zmq_poller reports a timeout as EAGAIN.
+        if (zmq_errno() == EAGAIN)
+        {
+            return;
+        }
+
+        throw Error();
+    }
+
+    for (int i = 0; i < eventCount; ++i)
+    {
+        const zmq_poller_event_t& event = mPollerEvents[i];
+        addReadyItem(static_cast<Registration*>(event.user_data), event.events);
+    }
+#else
+    if (zmq_poll(mItems.data(), static_cast<int>(mItems.size()), timeout) < 0)
+    {
+        throw Error();
+    }
+
+    for (size_t i = 0; i < mItems.size(); ++i)
+    {
+        if (0 != mItems[i].revents)
+        {
+            addReadyItem(mRegistrations[i].get(), mItems[i].revents);
+        }
+    }
+#endif
+}
+
+inline
+auto Poller::advancePendingTimers() -> void
+{
+    if (mIsTimerAdvancePending)
+    {
+        mIsTimerAdvancePending = false;
+        mTimerWheel.advance();
+    }
+}
+
+inline
+auto Poller::addReadyItem(Registration* registration, const short events) -> void
+{
+    ReadyItem readyItem;
+    readyItem.mRegistration   = registration;
+    readyItem.mSocket         = registration->socket;
+    readyItem.mFileDescriptor = registration->item.fd;
+    readyItem.mEvents         = events;
+    mReadyItems.push_back(readyItem);
+}
+
+inline
+auto Poller::getWaitTimeout() const -> long
+{
+    const long timerTimeout = mTimerWheel.getTimeout();
+    if (timerTimeout < 0)
+    {
+        return mTimeout;
+    }
+
+    return (mTimeout < 0) ? timerTimeout : std::min(mTimeout, timerTimeout);
+}
+
+inline
+auto Poller::makeItem(PollItem& pollItem) -> zmq_pollitem_t
+{
+    zmq_pollitem_t item;
+    item.socket  = pollItem.getRawSocket();
+    item.fd      = pollItem.getFileDescriptor();
+    item.events  = static_cast<short>(pollItem.getEvents());
+    item.revents = 0;
+    return item;
+}
+
 template <size_t N, typename... PollItemTypes>
 inline
 auto Poller::poll( std::array<zmq_pollitem_t, N>& pollItemArray
@@ -89,15 +797,7 @@ auto Poller::poll( std::array<zmq_pollitem_t, N>& pollItemArray
                  , PollItem& pollItem
                  , PollItemTypes&... pollItems ) -> void
 {
-    CPPEROMQ_ASSERT(nullptr != pollItem.getRawSocket());
-
-    zmq_pollitem_t internalPollItem;
-    internalPollItem.socket  = static_cast<void*>(pollItem.getRawSocket());
-    internalPollItem.fd      = 0;
-    internalPollItem.events  = pollItem.getEvents();
-    internalPollItem.revents = 0;
-
-    std::get<sizeof...(pollItems)>(pollItemArray) = internalPollItem;
+    std::get<sizeof...(pollItems)>(pollItemArray) = makeItem(pollItem);
     std::get<sizeof...(pollItems)>(callbackArray) = pollItem.getCallback();
 
     poll(pollItemArray, callbackArray, pollItems...);
@@ -108,7 +808,9 @@ inline
 auto Poller::poll( std::array<zmq_pollitem_t, N>& pollItemArray
                  , std::array<PollItem::Callback, N>& callbackArray ) -> void
 {
-    if (zmq_poll(pollItemArray.data(), N, mTimeout) < 0)
+    advancePendingTimers();
+
+    if (zmq_poll(pollItemArray.data(), N, getWaitTimeout()) < 0)
     {
         throw Error();
     }
@@ -117,16 +819,13 @@ auto Poller::poll( std::array<zmq_pollitem_t, N>& pollItemArray
     {
         if (callbackArray[i])
         {
-            if (pollItemArray[i].revents & ZMQ_POLLIN)
-            {
-                callbackArray[i]();
-            }
-            else if (pollItemArray[i].revents & ZMQ_POLLOUT)
+            if (pollItemArray[i].revents & (ZMQ_POLLIN | ZMQ_POLLOUT | ZMQ_POLLERR))
             {
                 callbackArray[i]();
             }
         }
     }
+    mTimerWheel.advance();
 }
 
 }
@@ -0,0 +1,420 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/DealerSocket.hpp>
+#include <CpperoMQ/ExtendedPublishSocket.hpp>
+#include <CpperoMQ/ExtendedSubscribeSocket.hpp>
+#include <CpperoMQ/MultipartMessage.hpp>
+#include <CpperoMQ/OutgoingMessage.hpp>
+#include <CpperoMQ/Poller.hpp>
+#include <CpperoMQ/PublishSocket.hpp>
+#include <CpperoMQ/PullSocket.hpp>
+#include <CpperoMQ/PushSocket.hpp>
+#include <CpperoMQ/Result.hpp>
+#include <CpperoMQ/RouterSocket.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+enum class ProxyDirection { FrontendToBackend, BackendToFrontend };
+
+// The hooks of a ProxyEngine, all of which forward everything unchanged.
+// Custom hooks derive from ProxyHooks and hide the members they replace; as
+// they are resolved at compile time, unused hooks cost nothing.
+class ProxyHooks
+{
+public:
+    // Returns false to drop a message before any of its frames are moved.
+    auto filter(const ProxyDirection direction, const MultipartMessage& message) -> bool;
+
+    // May rewrite, add or remove frames.  A message left without frames is
+    // dropped.
+    auto transform(const ProxyDirection direction, std::vector<OutgoingMessage>& frames) -> void;
+
+    // Returns the socket to send a message to instead of the other side of
+    // the proxy, or null to send it there.
+    auto route(const ProxyDirection direction, const std::vector<OutgoingMessage>& frames) -> Socket*;
+
+    // Returns whether to copy a message to the capture socket, if one is
+    // set.  Capture copies share the frames' data rather than copying it.
+    auto capture(const ProxyDirection direction, const std::vector<OutgoingMessage>& frames) -> bool;
+};
+
+// A proxy loop in place of zmq_proxy, for when traffic has to be inspected
+// or altered on the way through.  Frames are moved, not copied, from the
+// socket they arrive on to the one they leave by, and each wakeup forwards
+// up to 'burstSize' messages per ready socket before polling again.
+//
+// A message that cannot be queued on its destination (EAGAIN after a send
+// timeout, or EHOSTUNREACH from a router with mandatory routing) is dropped
+// and counted rather than ending the proxy.
+template <typename Frontend, typename Backend, typename Hooks = ProxyHooks>
+class ProxyEngine
+{
+    static_assert( (std::is_same<RouterSocket, Frontend>::value && std::is_same<DealerSocket, Backend>::value) ||
+                   (std::is_same<DealerSocket, Frontend>::value && std::is_same<RouterSocket, Backend>::value) ||
+
+                   (std::is_same<ExtendedSubscribeSocket, Frontend>::value && std::is_same<ExtendedPublishSocket,   Backend>::value) ||
+                   (std::is_same<ExtendedPublishSocket,   Frontend>::value && std::is_same<ExtendedSubscribeSocket, Backend>::value) ||
+
+                   (std::is_same<PullSocket, Frontend>::value && std::is_same<PushSocket, Backend>::value) ||
+                   (std::is_same<PushSocket, Frontend>::value && std::is_same<PullSocket, Backend>::value)
+
+                 , "Template parameters 'Frontend' and 'Backend' must be Router/Dealer, "
+                   "ExtendedSubscribe/ExtendedPublish, or Pull/Push." );
+
+public:
+    // How often, in milliseconds, run checks whether stop has been called.
+    static const long StopCheckInterval = 100;
+
+    ProxyEngine( Frontend& frontend
+               , Backend& backend
+               , Hooks hooks = Hooks()
+               , const size_t burstSize = 64 );
+    ProxyEngine(const ProxyEngine& other) = delete;
+    ProxyEngine& operator=(const ProxyEngine& other) = delete;
+
+    template <typename S>
+    auto setCaptureSocket(S& socket) -> void;
+
+    auto getHooks() -> Hooks&;
+
+    // Forwards messages until stop is called, from a hook or another thread.
+    auto run() -> void;
+    auto stop() -> void;
+
+    // Counts are only meaningful on the thread calling run, or after it has
+    // returned.
+    auto getForwardedCount(const ProxyDirection direction) const -> uint64_t;
+    auto getDroppedCount(const ProxyDirection direction) const   -> uint64_t;
+
+private:
+    template <typename S>
+    struct CanReceive : std::integral_constant<bool, !std::is_same<PushSocket, S>::value>
+    {
+    };
+
+    template <typename S>
+    auto addSource(Poller& poller, S& socket, std::true_type) -> void;
+
+    template <typename S>
+    auto addSource(Poller& poller, S& socket, std::false_type) -> void;
+
+    template <typename S>
+    auto forward( S& source
+                , Socket& destination
+                , const ProxyDirection direction
+                , std::true_type ) -> void;
+
+    template <typename S>
+    auto forward( S& source
+                , Socket& destination
+                , const ProxyDirection direction
+                , std::false_type ) -> void;
+
+    auto sendFrames(const Socket& destination) -> bool;
+    auto sendCapture() -> void;
+
+    Frontend& mFrontend;
+    Backend& mBackend;
+    Hooks mHooks;
+    size_t mBurstSize;
+    const Socket* mCaptureSocket;
+    std::atomic<bool> mIsStopped;
+
+    // Reused for every message.
+    MultipartMessage mMessage;
+    std::vector<OutgoingMessage> mFrames;
+
+    uint64_t mForwardedCounts[2];
+    uint64_t mDroppedCounts[2];
+};
+
+inline
+auto ProxyHooks::filter(const ProxyDirection, const MultipartMessage&) -> bool
+{
+    return true;
+}
+
+inline
+auto ProxyHooks::transform(const ProxyDirection, std::vector<OutgoingMessage>&) -> void
+{
+}
+
+inline
+auto ProxyHooks::route(const ProxyDirection, const std::vector<OutgoingMessage>&) -> Socket*
+{
+    return nullptr;
+}
+
+inline
+auto ProxyHooks::capture(const ProxyDirection, const std::vector<OutgoingMessage>&) -> bool
+{
+    return true;
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+ProxyEngine<Frontend, Backend, Hooks>::ProxyEngine( Frontend& frontend
+                                                  , Backend& backend
+                                                  , Hooks hooks
+                                                  , const size_t burstSize )
+    : mFrontend(frontend)
+    , mBackend(backend)
+    , mHooks(std::move(hooks))
+    , mBurstSize(burstSize)
+    , mCaptureSocket(nullptr)
+    , mIsStopped(false)
+    , mMessage()
+    , mFrames()
+    , mForwardedCounts()
+    , mDroppedCounts()
+{
+    CPPEROMQ_ASSERT(burstSize > 0);
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+template <typename S>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::setCaptureSocket(S& socket) -> void
+{
+    static_assert( std::is_same<DealerSocket,  S>::value ||
+                   std::is_same<PublishSocket, S>::value ||
+                   std::is_same<PushSocket,    S>::value
+                 , "Template parameter 'S' must be DealerSocket, "
+                   "PublishSocket, or PushSocket." );
+
+    mCaptureSocket = &socket;
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::getHooks() -> Hooks&
+{
+    return mHooks;
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::run() -> void
+{
+    Poller poller(StopCheckInterval);
+    addSource(poller, mFrontend, CanReceive<Frontend>());
+    addSource(poller, mBackend, CanReceive<Backend>());
+
+    const Socket* const frontend = &mFrontend;
+    mIsStopped = false;
+
+    while (!mIsStopped)
+    {
+        poller.wait([&](const Poller::ReadyItem& readyItem)
+        {
+            if (readyItem.getSocket() == frontend)
+            {
+                forward( mFrontend
+                       , mBackend
+                       , ProxyDirection::FrontendToBackend
+                       , CanReceive<Frontend>() );
+            }
+            else
+            {
+                forward( mBackend
+                       , mFrontend
+                       , ProxyDirection::BackendToFrontend
+                       , CanReceive<Backend>() );
+            }
+        });
+    }
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::stop() -> void
+{
+    mIsStopped = true;
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::getForwardedCount(const ProxyDirection direction) const -> uint64_t
+{
+    return mForwardedCounts[static_cast<size_t>(direction)];
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::getDroppedCount(const ProxyDirection direction) const -> uint64_t
+{
+    return mDroppedCounts[static_cast<size_t>(direction)];
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+template <typename S>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::addSource(Poller& poller, S& socket, std::true_type) -> void
+{
+    poller.add(isReceiveReady(socket));
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+template <typename S>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::addSource(Poller&, S&, std::false_type) -> void
+{
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+template <typename S>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::forward( S& source
+                                                   , Socket& destination
+                                                   , const ProxyDirection direction
+                                                   , std::true_type ) -> void
+{
+    const size_t directionIndex = static_cast<size_t>(direction);
+
+    for (size_t i = 0; i < mBurstSize; ++i)
+    {
+        const Result result = source.tryReceive(ZMQ_DONTWAIT, mMessage);
+        if (result.isAgain())
+        {
+            break;
+        }
+
+        if (!checkResult(result))
+        {
+            continue;
+        }
+
+        if (!mHooks.filter(direction, mMessage))
+        {
+            ++mDroppedCounts[directionIndex];
+            continue;
+        }
+
+        mFrames.clear();
+        for (IncomingMessage& frame : mMessage)
+        {
+            mFrames.emplace_back(std::move(frame));
+        }
+
+        mHooks.transform(direction, mFrames);
+        if (mFrames.empty())
+        {
+            ++mDroppedCounts[directionIndex];
+            continue;
+        }
+
+        if (nullptr != mCaptureSocket && mHooks.capture(direction, mFrames))
+        {
+            sendCapture();
+        }
+
+        Socket* route = mHooks.route(direction, mFrames);
+        if (sendFrames((nullptr != route) ? *route : destination))
+        {
+            ++mForwardedCounts[directionIndex];
+        }
+        else
+        {
+            ++mDroppedCounts[directionIndex];
+        }
+    }
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+template <typename S>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::forward( S&
+                                                   , Socket&
+                                                   , const ProxyDirection
+                                                   , std::false_type ) -> void
+{
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::sendFrames(const Socket& destination) -> bool
+{
+    const size_t frameCount = mFrames.size();
+
+    Result result = mFrames[0].trySendAndRelease(destination, (frameCount > 1), 0);
+    if (!result)
+    {
+        if (result.isAgain() || EHOSTUNREACH == result.getErrorNumber())
+        {
+            return false;
+        }
+
+        checkResult(result);
+    }
+
+    // libzmq applies its high-water mark per message, so once the first
+    // frame is queued the rest are retried until they are too.
+    for (size_t i = 1; i < frameCount; ++i)
+    {
+        do
+        {
+            result = mFrames[i].trySendAndRelease(destination, (i + 1 < frameCount), 0);
+        }
+        while (result.isAgain());
+
+        checkResult(result);
+    }
+
+    return true;
+}
+
+template <typename Frontend, typename Backend, typename Hooks>
+inline
+auto ProxyEngine<Frontend, Backend, Hooks>::sendCapture() -> void
+{
+    const size_t frameCount = mFrames.size();
+
+    // Best effort: a capture socket that cannot keep up loses messages, but
+    // a copy it has started to take is always completed.
+    Result result = mFrames[0].trySend(*mCaptureSocket, (frameCount > 1), 0);
+    if (result.isAgain() || !checkResult(result))
+    {
+        return;
+    }
+
+    for (size_t i = 1; i < frameCount; ++i)
+    {
+        do
+        {
+            result = mFrames[i].trySend(*mCaptureSocket, (i + 1 < frameCount), 0);
+        }
+        while (result.isAgain());
+
+        checkResult(result);
+    }
+}
+
+}
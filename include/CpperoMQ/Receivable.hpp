@@ -22,9 +22,16 @@
 
 #pragma once
 
+#include <CpperoMQ/Result.hpp>
+#include <CpperoMQ/StaticReceivable.hpp>
+
+#include <type_traits>
+
 namespace CpperoMQ
 {
 
+class Socket;
+
 class Receivable
 {
     friend class Socket;
@@ -33,6 +40,43 @@ public:
     virtual ~Receivable() {}
 
     virtual auto receive(Socket& socket, bool& moreToReceive) -> bool = 0;
+
+    // Non-throwing variant of receive, made with extra libzmq flags such as
+    // ZMQ_DONTWAIT.  The default adapts receive(), reporting false as EAGAIN,
+    // and fails with ENOTSUP if any flags are given since receive() cannot
+    // pass them on; override it to support flags or to avoid exceptions
+    // entirely.
+    virtual auto tryReceive( Socket& socket
+                           , bool& moreToReceive
+                           , const int flags ) -> Result;
+};
+
+inline
+auto Receivable::tryReceive( Socket& socket
+                           , bool& moreToReceive
+                           , const int flags ) -> Result
+{
+    if (0 != flags)
+    {
+        return (Result(ENOTSUP));
+    }
+
+    try
+    {
+        return (receive(socket, moreToReceive)) ? Result() : Result(EAGAIN);
+    }
+    catch (const Error& error)
+    {
+        return Result(error.number());
+    }
+}
+
+template <typename T>
+struct IsReceivable
+    : std::integral_constant< bool
+                            , std::is_base_of<Receivable, typename std::decay<T>::type>::value ||
+                              IsStaticReceivable<T>::value >
+{
 };
 
 }
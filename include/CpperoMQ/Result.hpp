@@ -0,0 +1,123 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Common.hpp>
+
+#include <cerrno>
+
+namespace CpperoMQ
+{
+
+// Outcome of a non-throwing operation: success, or the error number reported
+// by libzmq.  EAGAIN means nothing happened and the operation may be retried;
+// EPROTO means a received message did not have the expected number or size
+// of parts.
+class Result
+{
+public:
+    Result() NOEXCEPT;
+    explicit Result(const int errorNumber) NOEXCEPT;
+
+    static auto fromErrno() NOEXCEPT -> Result;
+
+    explicit operator bool() const NOEXCEPT;
+
+    auto isSuccess() const NOEXCEPT      -> bool;
+    auto isAgain() const NOEXCEPT        -> bool;
+    auto getErrorNumber() const NOEXCEPT -> int;
+    auto what() const NOEXCEPT           -> const char*;
+
+private:
+    int mErrorNumber;
+};
+
+// Maps a Result onto the conventions of the throwing API: true on success,
+// false on EAGAIN or EPROTO, and an Error exception for anything else.
+auto checkResult(const Result& result) -> bool;
+
+inline
+Result::Result() NOEXCEPT
+    : mErrorNumber(0)
+{
+}
+
+inline
+Result::Result(const int errorNumber) NOEXCEPT
+    : mErrorNumber(errorNumber)
+{
+}
+
+inline
+auto Result::fromErrno() NOEXCEPT -> Result
+{
+    return Result(zmq_errno());
+}
+
+inline
+Result::operator bool() const NOEXCEPT
+{
+    return (0 == mErrorNumber);
+}
+
+inline
+auto Result::isSuccess() const NOEXCEPT -> bool
+{
+    return (0 == mErrorNumber);
+}
+
+inline
+auto Result::isAgain() const NOEXCEPT -> bool
+{
+    return (EAGAIN == mErrorNumber);
+}
+
+inline
+auto Result::getErrorNumber() const NOEXCEPT -> int
+{
+    return mErrorNumber;
+}
+
+inline
+auto Result::what() const NOEXCEPT -> const char*
+{
+    return zmq_strerror(mErrorNumber);
+}
+
+inline
+auto checkResult(const Result& result) -> bool
+{
+    if (result)
+    {
+        return true;
+    }
+
+    if (result.isAgain() || EPROTO == result.getErrorNumber())
+    {
+        return false;
+    }
+
+    throw Error(result.getErrorNumber());
+}
+
+}
@@ -0,0 +1,761 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Awaitable.hpp>
+#include <CpperoMQ/Poller.hpp>
+#include <CpperoMQ/TimerWheel.hpp>
+
+#if CPPEROMQ_HAS_COROUTINES
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+class Scheduler;
+
+// The coroutine type run by a Scheduler.  A Task does not start until it is
+// either spawned on a Scheduler or awaited by another Task; an exception
+// escaping an awaited Task is rethrown in the awaiting one.
+class Task final
+{
+    friend class Scheduler;
+
+public:
+    class promise_type;
+
+    ~Task();
+    Task(const Task& other) = delete;
+    Task(Task&& other);
+    Task& operator=(const Task& other) = delete;
+    Task& operator=(Task&& other);
+
+    auto operator co_await() && NOEXCEPT;
+
+    auto isDone() const -> bool;
+
+private:
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle);
+
+    auto release() -> Handle;
+
+    Handle mHandle;
+};
+
+class Task::promise_type final
+{
+    friend class Scheduler;
+    friend class Task;
+
+public:
+    auto get_return_object() -> Task;
+    auto initial_suspend() NOEXCEPT -> std::suspend_always;
+    auto final_suspend() NOEXCEPT;
+    auto return_void() -> void;
+    auto unhandled_exception() -> void;
+
+private:
+    std::coroutine_handle<> mContinuation; // the awaiting Task, if any
+    std::exception_ptr mException;
+    Scheduler* mScheduler = nullptr;      // set once spawned
+};
+
+// Runs Tasks on the calling thread.  A Task that awaits a socket whose send
+// or receive would block is parked on that socket; each turn of run waits on
+// all parked sockets at once through a Poller, retries the parked operations
+// of those that are ready in arrival order, and resumes the Tasks whose
+// operations completed.  Nothing is polled while there are Tasks ready to
+// resume.
+//
+// A socket must not be awaited by Tasks on more than one Scheduler.
+class Scheduler final : public AsyncContext
+{
+    friend class Task::promise_type;
+
+public:
+    Scheduler();
+    ~Scheduler();
+    Scheduler(const Scheduler& other) = delete;
+    Scheduler(Scheduler&& other) = delete;
+    Scheduler& operator=(const Scheduler& other) = delete;
+    Scheduler& operator=(Scheduler&& other) = delete;
+
+    // Takes ownership of 'task', which starts on the next turn of run.  Tasks
+    // may be spawned from within other Tasks.
+    auto spawn(Task&& task) -> void;
+
+    // Runs until every spawned Task has finished, stop is called, or the
+    // remaining Tasks are waiting on nothing that could resume them.  The
+    // first exception to escape a spawned Task is rethrown from run.
+    auto run() -> void;
+    auto stop() -> void;
+
+    // Awaitables that resume the awaiting Task after 'delay', or on the next
+    // turn of run.
+    auto sleepFor(const std::chrono::milliseconds delay);
+    auto yield();
+
+    // Timers fire on the thread running run, between resumptions.
+    auto getTimerWheel() -> TimerWheel&;
+
+    virtual auto suspend(Socket& socket, const int events, AsyncOperation& operation) -> void override;
+    virtual auto cancel(Socket& socket, AsyncOperation& operation) -> void override;
+
+    // Resumes 'handle' on the next turn of run.
+    virtual auto schedule(std::coroutine_handle<> handle) -> void override;
+
+private:
+    class CurrentScope final
+    {
+    public:
+        explicit CurrentScope(Scheduler& scheduler);
+        ~CurrentScope();
+        CurrentScope(const CurrentScope& other) = delete;
+        CurrentScope& operator=(const CurrentScope& other) = delete;
+
+    private:
+        AsyncContext* mPrevious;
+    };
+
+    class WaitItem final : public PollItem
+    {
+    public:
+        WaitItem(const int events, Socket& socket);
+    };
+
+    class OperationQueue final
+    {
+    public:
+        auto empty() const -> bool;
+        auto front() const -> AsyncOperation&;
+        auto push(AsyncOperation& operation) -> void;
+        auto pop() -> void;
+        auto remove(AsyncOperation& operation) -> bool;
+
+    private:
+        AsyncOperation* mHead = nullptr;
+        AsyncOperation* mTail = nullptr;
+    };
+
+    struct Waiters
+    {
+        OperationQueue receivers;
+        OperationQueue senders;
+        int registeredEvents;
+    };
+
+    auto complete(OperationQueue& operations) -> void;
+    auto finish(Task::Handle handle) -> void;
+    auto resumeReady() -> void;
+    auto updateRegistration(Socket& socket, Waiters& waiters) -> void;
+
+    Poller mPoller;
+    std::unordered_map<Socket*, Waiters> mWaiters;
+    std::vector<Socket*> mReadySockets;
+    std::deque<std::coroutine_handle<>> mReadyHandles;
+    std::unordered_set<void*> mTasks; // addresses of spawned, unfinished Tasks
+    std::exception_ptr mException;
+    bool mIsDispatching;
+    bool mIsStopped;
+};
+
+inline
+Task::Task(Handle handle)
+    : mHandle(handle)
+{
+}
+
+inline
+Task::~Task()
+{
+    if (mHandle)
+    {
+        mHandle.destroy();
+    }
+}
+
+inline
+Task::Task(Task&& other)
+    : mHandle(other.release())
+{
+}
+
+inline
+Task& Task::operator=(Task&& other)
+{
+    if (this != &other)
+    {
+        if (mHandle)
+        {
+            mHandle.destroy();
+        }
+
+        mHandle = other.release();
+    }
+
+    return (*this);
+}
+
+inline
+auto Task::operator co_await() && NOEXCEPT
+{
+    class Awaiter final
+    {
+    public:
+        explicit Awaiter(Handle handle)
+            : mHandle(handle)
+        {
+        }
+
+        auto await_ready() const NOEXCEPT -> bool
+        {
+            return (!mHandle || mHandle.done());
+        }
+
+        // Starts the awaited Task, which resumes the awaiting one when done.
+        auto await_suspend(std::coroutine_handle<> continuation) NOEXCEPT -> std::coroutine_handle<>
+        {
+            mHandle.promise().mContinuation = continuation;
+            return (mHandle);
+        }
+
+        auto await_resume() -> void
+        {
+            if (mHandle && mHandle.promise().mException)
+            {
+                std::rethrow_exception(mHandle.promise().mException);
+            }
+        }
+
+    private:
+        Handle mHandle;
+    };
+
+    return (Awaiter(mHandle));
+}
+
+inline
+auto Task::isDone() const -> bool
+{
+    return (!mHandle || mHandle.done());
+}
+
+inline
+auto Task::release() -> Handle
+{
+    return (std::exchange(mHandle, nullptr));
+}
+
+inline
+auto Task::promise_type::get_return_object() -> Task
+{
+    return (Task(Handle::from_promise(*this)));
+}
+
+inline
+auto Task::promise_type::initial_suspend() NOEXCEPT -> std::suspend_always
+{
+    return (std::suspend_always());
+}
+
+inline
+auto Task::promise_type::final_suspend() NOEXCEPT
+{
+    class FinalAwaiter final
+    {
+    public:
+        auto await_ready() const NOEXCEPT -> bool
+        {
+            return false;
+        }
+
+        // An awaited Task hands control back to the Task awaiting it.  A
+        // spawned Task is destroyed by its Scheduler.
+        auto await_suspend(Handle handle) NOEXCEPT -> std::coroutine_handle<>
+        {
+            promise_type& promise = handle.promise();
+            if (promise.mContinuation)
+            {
+                return (promise.mContinuation);
+            }
+
+            if (nullptr != promise.mScheduler)
+            {
+                promise.mScheduler->finish(handle);
+            }
+
+            return (std::noop_coroutine());
+        }
+
+        auto await_resume() const NOEXCEPT -> void
+        {
+        }
+    };
+
+    return (FinalAwaiter());
+}
+
+inline
+auto Task::promise_type::return_void() -> void
+{
+}
+
+inline
+auto Task::promise_type::unhandled_exception() -> void
+{
+    mException = std::current_exception();
+}
+
+inline
+Scheduler::Scheduler()
+    : AsyncContext()
+    , mPoller()
+    , mWaiters()
+    , mReadySockets()
+    , mReadyHandles()
+    , mTasks()
+    , mException()
+    , mIsDispatching(false)
+    , mIsStopped(false)
+{
+}
+
+inline
+Scheduler::~Scheduler()
+{
+    // Unfinished Tasks are destroyed while suspended; their parked
+    // operations go with them.
+    for (void* address : mTasks)
+    {
+        std::coroutine_handle<>::from_address(address).destroy();
+    }
+}
+
+inline
+auto Scheduler::spawn(Task&& task) -> void
+{
+    CPPEROMQ_ASSERT(!task.isDone());
+
+    Task::Handle handle = task.release();
+    handle.promise().mScheduler = this;
+    mTasks.insert(handle.address());
+    mReadyHandles.push_back(handle);
+}
+
+inline
+auto Scheduler::run() -> void
+{
+    const CurrentScope currentScope(*this);
+    mIsStopped = false;
+
+    const auto handler = [this](const Poller::ReadyItem& readyItem)
+    {
+        const auto iterator = mWaiters.find(readyItem.getSocket());
+        if (iterator == mWaiters.end())
+        {
+            return;
+        }
+
+        Waiters& waiters = iterator->second;
+        if (readyItem.isReceiveReady())
+        {
+            complete(waiters.receivers);
+        }
+
+        if (readyItem.isSendReady())
+        {
+            complete(waiters.senders);
+        }
+
+        mReadySockets.push_back(readyItem.getSocket());
+    };
+
+    while (!mIsStopped && !mTasks.empty())
+    {
+        resumeReady();
+
+        if (mException)
+        {
+            std::rethrow_exception(std::exchange(mException, nullptr));
+        }
+
+        if (mIsStopped || mTasks.empty())
+        {
+            break;
+        }
+
+        if (mReadyHandles.empty() && mWaiters.empty() && mPoller.getTimerWheel().empty())
+        {
+            break;
+        }
+
+        mPoller.setTimeout(mReadyHandles.empty() ? -1 : 0);
+
+        mIsDispatching = true;
+        try
+        {
+            mPoller.wait(handler);
+        }
+        catch (...)
+        {
+            mIsDispatching = false;
+            throw;
+        }
+        mIsDispatching = false;
+
+        // Registrations are only changed once the Poller has finished
+        // dispatching.
+        for (Socket* socket : mReadySockets)
+        {
+            const auto iterator = mWaiters.find(socket);
+            if (iterator != mWaiters.end())
+            {
+                updateRegistration(*socket, iterator->second);
+            }
+        }
+
+        mReadySockets.clear();
+    }
+}
+
+inline
+auto Scheduler::stop() -> void
+{
+    mIsStopped = true;
+}
+
+inline
+auto Scheduler::sleepFor(const std::chrono::milliseconds delay)
+{
+    class SleepAwaiter final
+    {
+    public:
+        SleepAwaiter(Scheduler& scheduler, const std::chrono::milliseconds delay)
+            : mScheduler(scheduler)
+            , mDelay(delay)
+        {
+        }
+
+        auto await_ready() const NOEXCEPT -> bool
+        {
+            return (mDelay.count() <= 0);
+        }
+
+        auto await_suspend(std::coroutine_handle<> handle) -> void
+        {
+            Scheduler& scheduler = mScheduler;
+            mScheduler.getTimerWheel().add(mDelay, [&scheduler, handle]()
+            {
+                scheduler.schedule(handle);
+            });
+        }
+
+        auto await_resume() const NOEXCEPT -> void
+        {
+        }
+
+    private:
+        Scheduler& mScheduler;
+        std::chrono::milliseconds mDelay;
+    };
+
+    return (SleepAwaiter(*this, delay));
+}
+
+inline
+auto Scheduler::yield()
+{
+    class YieldAwaiter final
+    {
+    public:
+        explicit YieldAwaiter(Scheduler& scheduler)
+            : mScheduler(scheduler)
+        {
+        }
+
+        auto await_ready() const NOEXCEPT -> bool
+        {
+            return false;
+        }
+
+        auto await_suspend(std::coroutine_handle<> handle) -> void
+        {
+            mScheduler.schedule(handle);
+        }
+
+        auto await_resume() const NOEXCEPT -> void
+        {
+        }
+
+    private:
+        Scheduler& mScheduler;
+    };
+
+    return (YieldAwaiter(*this));
+}
+
+inline
+auto Scheduler::getTimerWheel() -> TimerWheel&
+{
+    return mPoller.getTimerWheel();
+}
+
+inline
+auto Scheduler::suspend(Socket& socket, const int events, AsyncOperation& operation) -> void
+{
+    CPPEROMQ_ASSERT(ZMQ_POLLIN == events || ZMQ_POLLOUT == events);
+
+    auto iterator = mWaiters.find(&socket);
+    if (iterator == mWaiters.end())
+    {
+        iterator = mWaiters.emplace(&socket, Waiters{ OperationQueue(), OperationQueue(), 0 }).first;
+    }
+
+    Waiters& waiters = iterator->second;
+    if (ZMQ_POLLIN == events)
+    {
+        waiters.receivers.push(operation);
+    }
+    else
+    {
+        waiters.senders.push(operation);
+    }
+
+    updateRegistration(socket, waiters);
+}
+
+inline
+auto Scheduler::cancel(Socket& socket, AsyncOperation& operation) -> void
+{
+    const auto iterator = mWaiters.find(&socket);
+    if (iterator == mWaiters.end())
+    {
+        return;
+    }
+
+    Waiters& waiters = iterator->second;
+    if (waiters.receivers.remove(operation) || waiters.senders.remove(operation))
+    {
+        updateRegistration(socket, waiters);
+    }
+}
+
+inline
+auto Scheduler::schedule(std::coroutine_handle<> handle) -> void
+{
+    mReadyHandles.push_back(handle);
+}
+
+inline
+Scheduler::CurrentScope::CurrentScope(Scheduler& scheduler)
+    : mPrevious(setCurrent(&scheduler))
+{
+}
+
+inline
+Scheduler::CurrentScope::~CurrentScope()
+{
+    setCurrent(mPrevious);
+}
+
+inline
+Scheduler::WaitItem::WaitItem(const int events, Socket& socket)
+    : PollItem(events, socket)
+{
+}
+
+inline
+auto Scheduler::OperationQueue::empty() const -> bool
+{
+    return (nullptr == mHead);
+}
+
+inline
+auto Scheduler::OperationQueue::front() const -> AsyncOperation&
+{
+    CPPEROMQ_ASSERT(nullptr != mHead);
+    return (*mHead);
+}
+
+inline
+auto Scheduler::OperationQueue::push(AsyncOperation& operation) -> void
+{
+    operation.setNext(nullptr);
+
+    if (nullptr == mTail)
+    {
+        mHead = &operation;
+    }
+    else
+    {
+        mTail->setNext(&operation);
+    }
+
+    mTail = &operation;
+}
+
+inline
+auto Scheduler::OperationQueue::pop() -> void
+{
+    CPPEROMQ_ASSERT(nullptr != mHead);
+
+    mHead = mHead->getNext();
+    if (nullptr == mHead)
+    {
+        mTail = nullptr;
+    }
+}
+
+inline
+auto Scheduler::OperationQueue::remove(AsyncOperation& operation) -> bool
+{
+    AsyncOperation* previous = nullptr;
+
+    for (AsyncOperation* current = mHead; nullptr != current; current = current->getNext())
+    {
+        if (current == &operation)
+        {
+            if (nullptr == previous)
+            {
+                mHead = current->getNext();
+            }
+            else
+            {
+                previous->setNext(current->getNext());
+            }
+
+            if (mTail == current)
+            {
+                mTail = previous;
+            }
+
+            return true;
+        }
+
+        previous = current;
+    }
+
+    return false;
+}
+
+inline
+auto Scheduler::complete(OperationQueue& operations) -> void
+{
+    // Stops at the first operation that would still block, leaving it and
+    // those parked after it in place.
+    while (!operations.empty())
+    {
+        AsyncOperation& operation = operations.front();
+        if (!operation.tryComplete())
+        {
+            break;
+        }
+
+        const std::coroutine_handle<> handle = operation.getHandle();
+        operations.pop();
+
+        if (handle)
+        {
+            mReadyHandles.push_back(handle);
+        }
+    }
+}
+
+inline
+auto Scheduler::finish(Task::Handle handle) -> void
+{
+    if (handle.promise().mException && !mException)
+    {
+        mException = handle.promise().mException;
+    }
+
+    mTasks.erase(handle.address());
+    handle.destroy();
+}
+
+inline
+auto Scheduler::resumeReady() -> void
+{
+    // Handles scheduled while resuming wait for the next turn, so a Task that
+    // keeps yielding cannot starve parked sockets.
+    for (size_t count = mReadyHandles.size(); count > 0 && !mIsStopped; --count)
+    {
+        const std::coroutine_handle<> handle = mReadyHandles.front();
+        mReadyHandles.pop_front();
+        handle.resume();
+    }
+}
+
+inline
+auto Scheduler::updateRegistration(Socket& socket, Waiters& waiters) -> void
+{
+    // While the Poller dispatches, the handler holds references into
+    // mWaiters, so the change is left to the pass that follows the wait.
+    if (mIsDispatching)
+    {
+        mReadySockets.push_back(&socket);
+        return;
+    }
+
+    const int events = (waiters.receivers.empty() ? 0 : ZMQ_POLLIN)
+                     | (waiters.senders.empty()   ? 0 : ZMQ_POLLOUT);
+
+    if (events == waiters.registeredEvents)
+    {
+        return;
+    }
+
+    if (0 == waiters.registeredEvents)
+    {
+        mPoller.add(WaitItem(events, socket));
+    }
+    else if (0 == events)
+    {
+        mPoller.remove(socket);
+    }
+    else
+    {
+        mPoller.modify(WaitItem(events, socket));
+    }
+
+    waiters.registeredEvents = events;
+
+    if (0 == events)
+    {
+        mWaiters.erase(&socket);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,392 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/BufferReceiver.hpp>
+#include <CpperoMQ/IncomingMessage.hpp>
+#include <CpperoMQ/OutgoingMessage.hpp>
+#include <CpperoMQ/Receivable.hpp>
+#include <CpperoMQ/Sendable.hpp>
+
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace CpperoMQ
+{
+
+template <typename T>
+struct IsSchemaField
+    : std::integral_constant< bool
+                            , (std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value) ||
+                              std::is_same<std::string, T>::value >
+{
+};
+
+template <typename... Types>
+struct AreSchemaFields;
+
+template <>
+struct AreSchemaFields<> : std::true_type
+{
+};
+
+template <typename T, typename... Types>
+struct AreSchemaFields<T, Types...>
+    : std::integral_constant< bool
+                            , IsSchemaField<T>::value && AreSchemaFields<Types...>::value >
+{
+};
+
+// Maps each field onto one frame of a multipart message.  Trivially copyable
+// fields are sent as their object representation and must arrive with
+// exactly sizeof(T) bytes; std::string fields may have any size.  The frame
+// walk is expanded at compile time, so no virtual call is made per frame.
+// A frame of the wrong size, or too few frames, is reported as EPROTO; the
+// rest of the message is discarded so the next receive starts on a message
+// boundary.
+template <typename... Types>
+class Schema final : public Sendable, public Receivable
+{
+    static_assert( sizeof...(Types) > 0
+                 , "Schema must have at least one field." );
+    static_assert( AreSchemaFields<Types...>::value
+                 , "Schema fields must be trivially copyable non-pointer types or std::string." );
+
+public:
+    template <size_t Index>
+    using FieldType = typename std::tuple_element<Index, std::tuple<Types...>>::type;
+
+    Schema();
+    explicit Schema(const Types&... values);
+    virtual ~Schema() = default;
+    Schema(const Schema& other) = default;
+    Schema(Schema&& other) = default;
+    Schema& operator=(const Schema& other) = default;
+    Schema& operator=(Schema&& other) = default;
+
+    static const size_t FrameCount = sizeof...(Types);
+
+    template <size_t Index>
+    auto get() const -> const FieldType<Index>&;
+
+    template <size_t Index>
+    auto get() -> FieldType<Index>&;
+
+    virtual auto send(const Socket& socket, const bool moreToSend) const -> bool override;
+    virtual auto receive(Socket& socket, bool& moreToReceive) -> bool override;
+
+    virtual auto trySend( const Socket& socket
+                        , const bool moreToSend
+                        , const int flags ) const -> Result override;
+    virtual auto tryReceive( Socket& socket
+                           , bool& moreToReceive
+                           , const int flags ) -> Result override;
+
+private:
+    template <size_t Index>
+    auto sendFields(const Socket& socket, const bool moreToSend, const int flags) const
+        -> typename std::enable_if<(Index < sizeof...(Types)), Result>::type;
+
+    template <size_t Index>
+    auto sendFields(const Socket& socket, const bool moreToSend, const int flags) const
+        -> typename std::enable_if<(Index == sizeof...(Types)), Result>::type;
+
+    template <size_t Index>
+    auto receiveFields(Socket& socket, bool& moreToReceive, const int flags)
+        -> typename std::enable_if<(Index < sizeof...(Types)), Result>::type;
+
+    template <size_t Index>
+    auto receiveFields(Socket& socket, bool& moreToReceive, const int flags)
+        -> typename std::enable_if<(Index == sizeof...(Types)), Result>::type;
+
+    template <typename T>
+    static auto sendField( const Socket& socket
+                         , const T& value
+                         , const bool moreToSend
+                         , const int flags ) -> Result;
+    static auto sendField( const Socket& socket
+                         , const std::string& value
+                         , const bool moreToSend
+                         , const int flags ) -> Result;
+
+    template <typename T>
+    static auto receiveField( Socket& socket
+                            , T& value
+                            , bool& moreToReceive
+                            , const int flags ) -> Result;
+    static auto receiveField( Socket& socket
+                            , std::string& value
+                            , bool& moreToReceive
+                            , const int flags ) -> Result;
+
+    static auto discardRemainingFrames( Socket& socket
+                                      , bool& moreToReceive
+                                      , const int flags ) -> void;
+
+    std::tuple<Types...> mFields;
+};
+
+template <typename... Types>
+inline
+Schema<Types...>::Schema()
+    : mFields()
+{
+}
+
+template <typename... Types>
+inline
+Schema<Types...>::Schema(const Types&... values)
+    : mFields(values...)
+{
+}
+
+template <typename... Types>
+template <size_t Index>
+inline
+auto Schema<Types...>::get() const -> const FieldType<Index>&
+{
+    return (std::get<Index>(mFields));
+}
+
+template <typename... Types>
+template <size_t Index>
+inline
+auto Schema<Types...>::get() -> FieldType<Index>&
+{
+    return (std::get<Index>(mFields));
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::send(const Socket& socket, const bool moreToSend) const -> bool
+{
+    return (checkResult(trySend(socket, moreToSend, 0)));
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::receive(Socket& socket, bool& moreToReceive) -> bool
+{
+    return (checkResult(tryReceive(socket, moreToReceive, 0)));
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::trySend( const Socket& socket
+                              , const bool moreToSend
+                              , const int flags ) const -> Result
+{
+    return (sendFields<0>(socket, moreToSend, flags));
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::tryReceive( Socket& socket
+                                 , bool& moreToReceive
+                                 , const int flags ) -> Result
+{
+    return (receiveFields<0>(socket, moreToReceive, flags));
+}
+
+template <typename... Types>
+template <size_t Index>
+inline
+auto Schema<Types...>::sendFields( const Socket& socket
+                                 , const bool moreToSend
+                                 , const int flags ) const
+    -> typename std::enable_if<(Index < sizeof...(Types)), Result>::type
+{
+    const bool isLastField = (Index + 1 == sizeof...(Types));
+
+    const Result result = sendField( socket
+                                   , std::get<Index>(mFields)
+                                   , (isLastField) ? moreToSend : true
+                                   , flags );
+    if (!result)
+    {
+        return result;
+    }
+
+    return (sendFields<Index + 1>(socket, moreToSend, flags));
+}
+
+template <typename... Types>
+template <size_t Index>
+inline
+auto Schema<Types...>::sendFields( const Socket& socket
+                                 , const bool moreToSend
+                                 , const int flags ) const
+    -> typename std::enable_if<(Index == sizeof...(Types)), Result>::type
+{
+    (void)socket;
+    (void)moreToSend;
+    (void)flags;
+    return (Result());
+}
+
+template <typename... Types>
+template <size_t Index>
+inline
+auto Schema<Types...>::receiveFields( Socket& socket
+                                    , bool& moreToReceive
+                                    , const int flags )
+    -> typename std::enable_if<(Index < sizeof...(Types)), Result>::type
+{
+    const bool isLastField = (Index + 1 == sizeof...(Types));
+
+    const Result result = receiveField(socket, std::get<Index>(mFields), moreToReceive, flags);
+    if (!result)
+    {
+        discardRemainingFrames(socket, moreToReceive, flags);
+        return result;
+    }
+
+    if (!isLastField && !moreToReceive)
+    {
+        return (Result(EPROTO));
+    }
+
+    return (receiveFields<Index + 1>(socket, moreToReceive, flags));
+}
+
+template <typename... Types>
+template <size_t Index>
+inline
+auto Schema<Types...>::receiveFields( Socket& socket
+                                    , bool& moreToReceive
+                                    , const int flags )
+    -> typename std::enable_if<(Index == sizeof...(Types)), Result>::type
+{
+    (void)socket;
+    (void)moreToReceive;
+    (void)flags;
+    return (Result());
+}
+
+template <typename... Types>
+template <typename T>
+inline
+auto Schema<Types...>::sendField( const Socket& socket
+                                , const T& value
+                                , const bool moreToSend
+                                , const int flags ) -> Result
+{
+    try
+    {
+        OutgoingMessage message(sizeof(T), static_cast<const void*>(&value));
+        return (message.trySendAndRelease(socket, moreToSend, flags));
+    }
+    catch (const Error& error)
+    {
+        return (Result(error.number()));
+    }
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::sendField( const Socket& socket
+                                , const std::string& value
+                                , const bool moreToSend
+                                , const int flags ) -> Result
+{
+    try
+    {
+        OutgoingMessage message(value.size(), value.data());
+        return (message.trySendAndRelease(socket, moreToSend, flags));
+    }
+    catch (const Error& error)
+    {
+        return (Result(error.number()));
+    }
+}
+
+template <typename... Types>
+template <typename T>
+inline
+auto Schema<Types...>::receiveField( Socket& socket
+                                   , T& value
+                                   , bool& moreToReceive
+                                   , const int flags ) -> Result
+{
+    // Raw storage keeps 'value' intact if the frame has the wrong size,
+    // without requiring T to be default constructible.
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type receivedValue;
+    BufferReceiver receiver(&receivedValue, sizeof(T));
+    const Result result = receiver.tryReceive(socket, moreToReceive, flags);
+    if (!result)
+    {
+        return result;
+    }
+
+    if (sizeof(T) != receiver.getFrameSize())
+    {
+        return (Result(EPROTO));
+    }
+
+    std::memcpy(static_cast<void*>(&value), &receivedValue, sizeof(T));
+    return (Result());
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::receiveField( Socket& socket
+                                   , std::string& value
+                                   , bool& moreToReceive
+                                   , const int flags ) -> Result
+{
+    try
+    {
+        IncomingMessage message;
+        const Result result = message.tryReceive(socket, moreToReceive, flags);
+        if (!result)
+        {
+            return result;
+        }
+
+        value.assign(message.charData(), message.size());
+        return (Result());
+    }
+    catch (const Error& error)
+    {
+        return (Result(error.number()));
+    }
+}
+
+template <typename... Types>
+inline
+auto Schema<Types...>::discardRemainingFrames( Socket& socket
+                                             , bool& moreToReceive
+                                             , const int flags ) -> void
+{
+    // A receiver without a buffer drops each frame without copying it.
+    BufferReceiver discarded(nullptr, 0);
+    while (moreToReceive && discarded.tryReceive(socket, moreToReceive, flags))
+    {
+    }
+
+    moreToReceive = false;
+}
+
+}
@@ -22,9 +22,16 @@
 
 #pragma once
 
+#include <CpperoMQ/Result.hpp>
+#include <CpperoMQ/StaticSendable.hpp>
+
+#include <type_traits>
+
 namespace CpperoMQ
 {
 
+class Socket;
+
 class Sendable
 {
     friend class Socket;
@@ -33,6 +40,42 @@ public:
     virtual ~Sendable() {}
 
     virtual auto send(const Socket& socket, const bool moreToSend) const -> bool = 0;
+
+    // Non-throwing variant of send, made with extra libzmq flags such as
+    // ZMQ_DONTWAIT.  The default adapts send(), reporting false as EAGAIN,
+    // and fails with ENOTSUP if any flags are given since send() cannot pass
+    // them on; override it to support flags or to avoid exceptions entirely.
+    virtual auto trySend( const Socket& socket
+                        , const bool moreToSend
+                        , const int flags ) const -> Result;
+};
+
+inline
+auto Sendable::trySend( const Socket& socket
+                      , const bool moreToSend
+                      , const int flags ) const -> Result
+{
+    if (0 != flags)
+    {
+        return (Result(ENOTSUP));
+    }
+
+    try
+    {
+        return (send(socket, moreToSend)) ? Result() : Result(EAGAIN);
+    }
+    catch (const Error& error)
+    {
+        return Result(error.number());
+    }
+}
+
+template <typename T>
+struct IsSendable
+    : std::integral_constant< bool
+                            , std::is_base_of<Sendable, typename std::decay<T>::type>::value ||
+                              IsStaticSendable<T>::value >
+{
 };
 
 }
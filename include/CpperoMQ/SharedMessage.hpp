@@ -0,0 +1,192 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/OutgoingMessage.hpp>
+#include <CpperoMQ/RouterSocket.hpp>
+#include <CpperoMQ/Sendable.hpp>
+#include <CpperoMQ/Socket.hpp>
+
+namespace CpperoMQ
+{
+
+// A payload built once and sent to many targets.  Every send shares the
+// payload through libzmq's reference count (zmq_msg_copy); the data itself
+// is never copied.
+class SharedMessage final : public Sendable
+{
+public:
+    explicit SharedMessage(OutgoingMessage&& payload);
+    virtual ~SharedMessage() = default;
+    SharedMessage(const SharedMessage& other) = delete;
+    SharedMessage(SharedMessage&& other);
+    SharedMessage& operator=(const SharedMessage& other) = delete;
+    SharedMessage& operator=(SharedMessage&& other);
+
+    auto getPayload() const -> const OutgoingMessage&;
+
+    // Sends the payload to each socket in the range (sockets or pointers to
+    // sockets) with ZMQ_DONTWAIT, so a full socket cannot stall the others.
+    // One bool per socket is written to 'results', false meaning that socket
+    // would have blocked (EAGAIN); other errors throw an Error.  Returns the
+    // number of successful sends.
+    template <typename SocketIterator, typename ResultIterator>
+    auto broadcast( SocketIterator firstSocket
+                  , SocketIterator lastSocket
+                  , ResultIterator results ) const -> size_t;
+
+    // Sends the payload to each peer of 'router' whose identity frame (any
+    // Sendable accepting ZMQ_DONTWAIT) is in the range.  Results are reported
+    // as for broadcast; a peer that is unreachable (EHOSTUNREACH with
+    // ZMQ_ROUTER_MANDATORY) is also reported as false and the remaining
+    // peers are still sent to.
+    template <typename IdentityIterator, typename ResultIterator>
+    auto route( const RouterSocket& router
+              , IdentityIterator firstIdentity
+              , IdentityIterator lastIdentity
+              , ResultIterator results ) const -> size_t;
+
+    virtual auto send(const Socket& socket, const bool moreToSend) const -> bool override;
+    virtual auto trySend( const Socket& socket
+                        , const bool moreToSend
+                        , const int flags ) const NOEXCEPT -> Result override;
+
+private:
+    static auto toSocket(const Socket& socket) -> const Socket&;
+    static auto toSocket(const Socket* socket) -> const Socket&;
+
+    OutgoingMessage mPayload;
+};
+
+inline
+SharedMessage::SharedMessage(OutgoingMessage&& payload)
+    : mPayload(std::move(payload))
+{
+}
+
+inline
+SharedMessage::SharedMessage(SharedMessage&& other)
+    : mPayload(std::move(other.mPayload))
+{
+}
+
+inline
+SharedMessage& SharedMessage::operator=(SharedMessage&& other)
+{
+    mPayload = std::move(other.mPayload);
+    return (*this);
+}
+
+inline
+auto SharedMessage::getPayload() const -> const OutgoingMessage&
+{
+    return mPayload;
+}
+
+template <typename SocketIterator, typename ResultIterator>
+inline
+auto SharedMessage::broadcast( SocketIterator firstSocket
+                             , SocketIterator lastSocket
+                             , ResultIterator results ) const -> size_t
+{
+    size_t sentCount = 0;
+
+    for (; firstSocket != lastSocket; ++firstSocket)
+    {
+        const Result result = mPayload.trySend(toSocket(*firstSocket), false, ZMQ_DONTWAIT);
+
+        const bool sent = checkResult(result);
+        if (sent)
+        {
+            ++sentCount;
+        }
+
+        *results = sent;
+        ++results;
+    }
+
+    return sentCount;
+}
+
+template <typename IdentityIterator, typename ResultIterator>
+inline
+auto SharedMessage::route( const RouterSocket& router
+                         , IdentityIterator firstIdentity
+                         , IdentityIterator lastIdentity
+                         , ResultIterator results ) const -> size_t
+{
+    size_t sentCount = 0;
+
+    for (; firstIdentity != lastIdentity; ++firstIdentity)
+    {
+        const Sendable& identity = *firstIdentity;
+
+        // A router with ZMQ_ROUTER_MANDATORY blocks at a full peer's
+        // high-water mark, so neither frame may wait.
+        Result result = identity.trySend(router, true, ZMQ_DONTWAIT);
+        if (result)
+        {
+            result = mPayload.trySend(router, false, ZMQ_DONTWAIT);
+        }
+
+        const bool sent = (EHOSTUNREACH != result.getErrorNumber()) && checkResult(result);
+        if (sent)
+        {
+            ++sentCount;
+        }
+
+        *results = sent;
+        ++results;
+    }
+
+    return sentCount;
+}
+
+inline
+auto SharedMessage::send(const Socket& socket, const bool moreToSend) const -> bool
+{
+    return (mPayload.send(socket, moreToSend));
+}
+
+inline
+auto SharedMessage::trySend( const Socket& socket
+                           , const bool moreToSend
+                           , const int flags ) const NOEXCEPT -> Result
+{
+    return (mPayload.trySend(socket, moreToSend, flags));
+}
+
+inline
+auto SharedMessage::toSocket(const Socket& socket) -> const Socket&
+{
+    return socket;
+}
+
+inline
+auto SharedMessage::toSocket(const Socket* socket) -> const Socket&
+{
+    CPPEROMQ_ASSERT(nullptr != socket);
+    return (*socket);
+}
+
+}
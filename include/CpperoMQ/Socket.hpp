@@ -23,6 +23,7 @@
 #pragma once
 
 #include <CpperoMQ/Common.hpp>
+#include <CpperoMQ/Result.hpp>
 
 #include <algorithm>
 #include <cstring>
@@ -32,10 +33,14 @@ namespace CpperoMQ
 
 class Socket
 {
+    friend class BufferReceiver;
     friend class IncomingMessage;
     friend class OutgoingMessage;
 
 public:
+    // SOCKET on Windows, int elsewhere.
+    using FileDescriptor = decltype(zmq_pollitem_t::fd);
+
     Socket() = delete;
     virtual ~Socket();
     Socket(const Socket& other) = delete;
@@ -46,8 +51,14 @@ public:
 
     auto connect(const char* address) -> void;
     auto disconnect(const char* address) -> void;
+
+    auto tryBind(const char* address) NOEXCEPT       -> Result;
+    auto tryUnbind(const char* address) NOEXCEPT     -> Result;
+    auto tryConnect(const char* address) NOEXCEPT    -> Result;
+    auto tryDisconnect(const char* address) NOEXCEPT -> Result;
     
     auto getBacklog() const                                 -> int;
+    auto getFileDescriptor() const                          -> FileDescriptor;
     auto getHandshakeInterval() const                       -> int;
     auto getImmediate() const                               -> bool;
     auto getIoThreadAffinity() const                        -> uint64_t;
@@ -56,6 +67,7 @@ public:
     auto getMaxReconnectInterval() const                    -> int;
     auto getMulticastRate() const                           -> int;
     auto getMulticastRecoveryInterval() const               -> int;
+    auto getPendingEvents() const                           -> int;
     auto getReconnectInterval() const                       -> int;
 
     auto setBacklog(const int backlog)                        -> void;
@@ -105,39 +117,67 @@ Socket::~Socket()
 inline
 auto Socket::bind(const char* address) -> void
 {
-    if (0 != zmq_bind(mSocket, address))
+    const Result result = tryBind(address);
+    if (!result)
     {
-        throw Error();
+        throw Error(result.getErrorNumber());
     }
 }
 
 inline
 auto Socket::unbind(const char* address) -> void
 {
-    if (0 != zmq_unbind(mSocket, address))
+    const Result result = tryUnbind(address);
+    if (!result)
     {
-        throw Error();
+        throw Error(result.getErrorNumber());
     }
 }
 
 inline
 auto Socket::connect(const char* address) -> void
 {
-    if (0 != zmq_connect(mSocket, address))
+    const Result result = tryConnect(address);
+    if (!result)
     {
-        throw Error();
+        throw Error(result.getErrorNumber());
     }
 }
 
 inline
 auto Socket::disconnect(const char* address) -> void
 {
-    if (0 != zmq_disconnect(mSocket, address))
+    const Result result = tryDisconnect(address);
+    if (!result)
     {
-        throw Error();
+        throw Error(result.getErrorNumber());
     }
 }
 
+inline
+auto Socket::tryBind(const char* address) NOEXCEPT -> Result
+{
+    return (0 == zmq_bind(mSocket, address)) ? Result() : Result::fromErrno();
+}
+
+inline
+auto Socket::tryUnbind(const char* address) NOEXCEPT -> Result
+{
+    return (0 == zmq_unbind(mSocket, address)) ? Result() : Result::fromErrno();
+}
+
+inline
+auto Socket::tryConnect(const char* address) NOEXCEPT -> Result
+{
+    return (0 == zmq_connect(mSocket, address)) ? Result() : Result::fromErrno();
+}
+
+inline
+auto Socket::tryDisconnect(const char* address) NOEXCEPT -> Result
+{
+    return (0 == zmq_disconnect(mSocket, address)) ? Result() : Result::fromErrno();
+}
+
 inline
 Socket::Socket(void* context, int type)
     : mSocket(nullptr)
@@ -172,6 +212,12 @@ auto Socket::getBacklog() const -> int
     return (getSocketOption<int>(ZMQ_BACKLOG));
 }
 
+inline
+auto Socket::getFileDescriptor() const -> FileDescriptor
+{
+    return (getSocketOption<FileDescriptor>(ZMQ_FD));
+}
+
 inline
 auto Socket::getHandshakeInterval() const -> int
 {
@@ -222,6 +268,12 @@ auto Socket::getMulticastRecoveryInterval() const -> int
     return (getSocketOption<int>(ZMQ_RECOVERY_IVL));
 }
 
+inline
+auto Socket::getPendingEvents() const -> int
+{
+    return (getSocketOption<int>(ZMQ_EVENTS));
+}
+
 inline
 auto Socket::getReconnectInterval() const -> int
 {
@@ -0,0 +1,113 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Common.hpp>
+
+#include <cstddef>
+
+namespace CpperoMQ
+{
+
+// A non-owning view of a contiguous sequence of T.
+template <typename T>
+class Span
+{
+public:
+    Span();
+    Span(T* data, const size_t size);
+
+    auto data() const  -> T*;
+    auto size() const  -> size_t;
+    auto empty() const -> bool;
+
+    auto begin() const -> T*;
+    auto end() const   -> T*;
+
+    auto operator[](const size_t index) const -> T&;
+
+private:
+    T* mData;
+    size_t mSize;
+};
+
+template <typename T>
+inline
+Span<T>::Span()
+    : mData(nullptr)
+    , mSize(0)
+{
+}
+
+template <typename T>
+inline
+Span<T>::Span(T* data, const size_t size)
+    : mData(data)
+    , mSize(size)
+{
+}
+
+template <typename T>
+inline
+auto Span<T>::data() const -> T*
+{
+    return mData;
+}
+
+template <typename T>
+inline
+auto Span<T>::size() const -> size_t
+{
+    return mSize;
+}
+
+template <typename T>
+inline
+auto Span<T>::empty() const -> bool
+{
+    return (0 == mSize);
+}
+
+template <typename T>
+inline
+auto Span<T>::begin() const -> T*
+{
+    return mData;
+}
+
+template <typename T>
+inline
+auto Span<T>::end() const -> T*
+{
+    return (mData + mSize);
+}
+
+template <typename T>
+inline
+auto Span<T>::operator[](const size_t index) const -> T&
+{
+    CPPEROMQ_ASSERT(index < mSize);
+    return mData[index];
+}
+
+}
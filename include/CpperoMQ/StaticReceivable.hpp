@@ -0,0 +1,87 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Result.hpp>
+
+#include <type_traits>
+
+namespace CpperoMQ
+{
+
+class Socket;
+
+// Compile-time counterpart of Receivable.  A class derives from
+// StaticReceivable<itself> and provides a non-virtual
+//
+//     auto receive(Socket& socket, bool& moreToReceive) -> bool;
+//
+// which ReceivingSocket::receive calls directly.  Unlike Receivable, a
+// StaticReceivable cannot be used through a base class reference; keep using
+// Receivable where type erasure is needed.
+//
+// The tryReceive below adapts receive() just like Receivable's default,
+// including rejecting flags with ENOTSUP; a derived class may hide it with
+// its own tryReceive taking the same arguments.
+template <typename Derived>
+class StaticReceivable
+{
+public:
+    auto tryReceive( Socket& socket
+                   , bool& moreToReceive
+                   , const int flags ) -> Result;
+
+protected:
+    ~StaticReceivable() = default;
+};
+
+template <typename Derived>
+inline
+auto StaticReceivable<Derived>::tryReceive( Socket& socket
+                                           , bool& moreToReceive
+                                           , const int flags ) -> Result
+{
+    if (0 != flags)
+    {
+        return (Result(ENOTSUP));
+    }
+
+    try
+    {
+        Derived& derived = static_cast<Derived&>(*this);
+        return (derived.receive(socket, moreToReceive)) ? Result() : Result(EAGAIN);
+    }
+    catch (const Error& error)
+    {
+        return Result(error.number());
+    }
+}
+
+template <typename T>
+struct IsStaticReceivable
+    : std::is_base_of< StaticReceivable<typename std::decay<T>::type>
+                     , typename std::decay<T>::type >
+{
+};
+
+}
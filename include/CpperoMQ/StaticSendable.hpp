@@ -0,0 +1,87 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Result.hpp>
+
+#include <type_traits>
+
+namespace CpperoMQ
+{
+
+class Socket;
+
+// Compile-time counterpart of Sendable.  A class derives from
+// StaticSendable<itself> and provides a non-virtual
+//
+//     auto send(const Socket& socket, const bool moreToSend) const -> bool;
+//
+// which SendingSocket::send calls directly.  Unlike Sendable, a
+// StaticSendable cannot be used through a base class reference; keep using
+// Sendable where type erasure is needed.
+//
+// The trySend below adapts send() just like Sendable's default, including
+// rejecting flags with ENOTSUP; a derived class may hide it with its own
+// trySend taking the same arguments.
+template <typename Derived>
+class StaticSendable
+{
+public:
+    auto trySend( const Socket& socket
+                , const bool moreToSend
+                , const int flags ) const -> Result;
+
+protected:
+    ~StaticSendable() = default;
+};
+
+template <typename Derived>
+inline
+auto StaticSendable<Derived>::trySend( const Socket& socket
+                                      , const bool moreToSend
+                                      , const int flags ) const -> Result
+{
+    if (0 != flags)
+    {
+        return (Result(ENOTSUP));
+    }
+
+    try
+    {
+        const Derived& derived = static_cast<const Derived&>(*this);
+        return (derived.send(socket, moreToSend)) ? Result() : Result(EAGAIN);
+    }
+    catch (const Error& error)
+    {
+        return Result(error.number());
+    }
+}
+
+template <typename T>
+struct IsStaticSendable
+    : std::is_base_of< StaticSendable<typename std::decay<T>::type>
+                     , typename std::decay<T>::type >
+{
+};
+
+}
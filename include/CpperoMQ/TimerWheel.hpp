@@ -0,0 +1,493 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2015 Jason Shipman
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <CpperoMQ/Common.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace CpperoMQ
+{
+
+// A hashed timing wheel.  Timers are hashed by deadline into a fixed number
+// of slots, each a doubly linked list, so adding and cancelling a timer is
+// O(1) however many are pending.  Timers further out than one turn of the
+// wheel share slots with nearer ones and are skipped until due.
+//
+// A Poller owns a TimerWheel: its poll timeout is shortened to the next
+// occupied slot, and due timers fire after I/O has been dispatched.
+class TimerWheel
+{
+public:
+    using Callback = std::function<void(void)>;
+    using Clock    = std::chrono::steady_clock;
+    using TimerId  = uint64_t;
+
+    // 'slotCount' must be a power of two and a multiple of 64.
+    explicit TimerWheel( const size_t slotCount = 1024
+                       , const std::chrono::milliseconds resolution = std::chrono::milliseconds(1) );
+
+    // Calls 'callback' once, 'delay' from now.
+    auto add(const std::chrono::milliseconds delay, Callback callback) -> TimerId;
+
+    // Calls 'callback' every 'interval' until cancelled.
+    auto addPeriodic(const std::chrono::milliseconds interval, Callback callback) -> TimerId;
+
+    // Returns false if the timer has already fired or been cancelled.  A
+    // periodic timer may cancel itself from its callback.
+    auto cancel(const TimerId timerId) -> bool;
+
+    auto empty() const -> bool;
+    auto size() const  -> size_t;
+
+    // Milliseconds until the next occupied slot is due, 0 if one is overdue
+    // and -1 if there are no timers, suitable as a poll timeout.
+    auto getTimeout() const -> long;
+
+    // Fires every timer that is due and returns how many fired.  Callbacks
+    // may add and cancel timers.  An exception thrown by a callback leaves
+    // advance, and the due timers that had not fired yet fire on the next
+    // call instead.
+    auto advance() -> size_t;
+
+private:
+    static const uint32_t InvalidIndex = 0xFFFFFFFF;
+    static const size_t BitsPerWord = 64;
+
+    enum class State { Free, Scheduled, Due };
+
+    struct Timer
+    {
+        uint64_t deadlineTick;
+        uint64_t intervalTicks; // 0 for one-shot timers
+        Callback callback;
+        uint32_t generation;
+        uint32_t previous;
+        uint32_t next;
+        State state;
+    };
+
+    struct DueTimer
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    auto addTimer( const uint64_t delayTicks
+                 , const uint64_t intervalTicks
+                 , Callback&& callback ) -> TimerId;
+    auto allocateTimer() -> uint32_t;
+    auto releaseTimer(const uint32_t index) -> void;
+    auto link(const uint32_t index) -> void;
+    auto unlink(const uint32_t index) -> void;
+    auto restoreCallback(const DueTimer& dueTimer, Callback&& callback) -> void;
+    auto rescheduleDueTimers(const std::vector<DueTimer>& dueTimers, const size_t first) -> void;
+
+    auto findNextOccupiedSlot(const size_t fromSlot) const -> size_t;
+    auto getCurrentTick() const -> uint64_t;
+    auto toTicks(const std::chrono::milliseconds duration) const -> uint64_t;
+
+    static auto makeTimerId(const uint32_t index, const uint32_t generation) -> TimerId;
+
+    std::vector<Timer> mTimers;
+    std::vector<uint32_t> mSlots;
+    std::vector<uint64_t> mOccupiedSlots;
+    std::vector<DueTimer> mDueTimers;
+    uint32_t mFreeList;
+    size_t mSize;
+    uint64_t mNextTick;
+    Clock::time_point mStartTime;
+    Clock::duration mResolution;
+};
+
+inline
+TimerWheel::TimerWheel( const size_t slotCount
+                      , const std::chrono::milliseconds resolution )
+    : mTimers()
+    , mSlots(slotCount, static_cast<uint32_t>(InvalidIndex))
+    , mOccupiedSlots(slotCount / BitsPerWord, 0)
+    , mDueTimers()
+    , mFreeList(InvalidIndex)
+    , mSize(0)
+    , mNextTick(0)
+    , mStartTime(Clock::now())
+    , mResolution(resolution)
+{
+    CPPEROMQ_ASSERT(0 != slotCount && 0 == (slotCount & (slotCount - 1)));
+    CPPEROMQ_ASSERT(0 == (slotCount % BitsPerWord));
+    CPPEROMQ_ASSERT(resolution.count() > 0);
+}
+
+inline
+auto TimerWheel::add(const std::chrono::milliseconds delay, Callback callback) -> TimerId
+{
+    return (addTimer(toTicks(delay), 0, std::move(callback)));
+}
+
+inline
+auto TimerWheel::addPeriodic(const std::chrono::milliseconds interval, Callback callback) -> TimerId
+{
+    const uint64_t intervalTicks = toTicks(interval);
+    return (addTimer(intervalTicks, (0 != intervalTicks) ? intervalTicks : 1, std::move(callback)));
+}
+
+inline
+auto TimerWheel::cancel(const TimerId timerId) -> bool
+{
+    const uint32_t index = static_cast<uint32_t>(timerId);
+    const uint32_t generation = static_cast<uint32_t>(timerId >> 32);
+
+    if (index >= mTimers.size() ||
+        mTimers[index].generation != generation ||
+        State::Free == mTimers[index].state)
+    {
+        return false;
+    }
+
+    if (State::Scheduled == mTimers[index].state)
+    {
+        unlink(index);
+    }
+
+    releaseTimer(index);
+    return true;
+}
+
+inline
+auto TimerWheel::empty() const -> bool
+{
+    return (0 == mSize);
+}
+
+inline
+auto TimerWheel::size() const -> size_t
+{
+    return mSize;
+}
+
+inline
+auto TimerWheel::getTimeout() const -> long
+{
+    if (0 == mSize)
+    {
+        return -1;
+    }
+
+    const size_t slotMask = mSlots.size() - 1;
+    const size_t nextSlot = findNextOccupiedSlot(static_cast<size_t>(mNextTick & slotMask));
+    const uint64_t slotTick = mNextTick + ((nextSlot - static_cast<size_t>(mNextTick & slotMask)) & slotMask);
+
+    const Clock::time_point slotTime = mStartTime + mResolution * static_cast<Clock::rep>(slotTick);
+    const Clock::time_point now = Clock::now();
+    if (slotTime <= now)
+    {
+        return 0;
+    }
+
+    // Round up so that the wait does not end just before the slot is due.
+    const auto remaining = slotTime - now;
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(remaining);
+    return static_cast<long>(milliseconds.count() + ((milliseconds < remaining) ? 1 : 0));
+}
+
+inline
+auto TimerWheel::advance() -> size_t
+{
+    const uint64_t currentTick = getCurrentTick();
+    if (currentTick < mNextTick || 0 == mSize)
+    {
+        mNextTick = (currentTick >= mNextTick) ? currentTick + 1 : mNextTick;
+        return 0;
+    }
+
+    // Each slot need only be visited once, however far behind we are.
+    const size_t slotMask = mSlots.size() - 1;
+    const uint64_t tickCount = std::min<uint64_t>(currentTick - mNextTick + 1, mSlots.size());
+
+    mDueTimers.clear();
+    for (uint64_t tick = mNextTick; tick < mNextTick + tickCount; ++tick)
+    {
+        uint32_t index = mSlots[static_cast<size_t>(tick & slotMask)];
+        while (InvalidIndex != index)
+        {
+            const uint32_t next = mTimers[index].next;
+            if (mTimers[index].deadlineTick <= currentTick)
+            {
+                unlink(index);
+                mTimers[index].state = State::Due;
+
+                DueTimer dueTimer = { index, mTimers[index].generation };
+                mDueTimers.push_back(dueTimer);
+            }
+
+            index = next;
+        }
+    }
+
+    mNextTick = currentTick + 1;
+
+    // Callbacks may add timers, which can reallocate mTimers and mDueTimers,
+    // so neither is referenced across a call.
+    std::vector<DueTimer> dueTimers;
+    dueTimers.swap(mDueTimers);
+
+    size_t firedCount = 0;
+    for (size_t i = 0; i < dueTimers.size(); ++i)
+    {
+        const DueTimer& dueTimer = dueTimers[i];
+        if (mTimers[dueTimer.index].generation != dueTimer.generation ||
+            State::Due != mTimers[dueTimer.index].state)
+        {
+            continue; // cancelled by an earlier callback
+        }
+
+        Callback callback = std::move(mTimers[dueTimer.index].callback);
+        const bool isPeriodic = (0 != mTimers[dueTimer.index].intervalTicks);
+        if (isPeriodic)
+        {
+            mTimers[dueTimer.index].deadlineTick = currentTick + mTimers[dueTimer.index].intervalTicks;
+            link(dueTimer.index);
+        }
+        else
+        {
+            releaseTimer(dueTimer.index);
+        }
+
+        ++firedCount;
+
+        try
+        {
+            callback();
+        }
+        catch (...)
+        {
+            // Unfired timers are in no slot yet still counted, so they are
+            // linked again rather than lost with the exception.
+            restoreCallback(dueTimer, std::move(callback));
+            rescheduleDueTimers(dueTimers, i + 1);
+            throw;
+        }
+
+        restoreCallback(dueTimer, std::move(callback));
+    }
+
+    dueTimers.clear();
+    if (mDueTimers.empty())
+    {
+        dueTimers.swap(mDueTimers); // keep the capacity
+    }
+
+    return firedCount;
+}
+
+inline
+auto TimerWheel::addTimer( const uint64_t delayTicks
+                         , const uint64_t intervalTicks
+                         , Callback&& callback ) -> TimerId
+{
+    const uint32_t index = allocateTimer();
+
+    Timer& timer = mTimers[index];
+    timer.deadlineTick  = std::max(getCurrentTick() + delayTicks, mNextTick);
+    timer.intervalTicks = intervalTicks;
+    timer.callback      = std::move(callback);
+    link(index);
+
+    ++mSize;
+    return (makeTimerId(index, timer.generation));
+}
+
+inline
+auto TimerWheel::allocateTimer() -> uint32_t
+{
+    if (InvalidIndex != mFreeList)
+    {
+        const uint32_t index = mFreeList;
+        mFreeList = mTimers[index].next;
+        return index;
+    }
+
+    CPPEROMQ_ASSERT(mTimers.size() < InvalidIndex);
+
+    Timer timer;
+    timer.deadlineTick  = 0;
+    timer.intervalTicks = 0;
+    timer.generation    = 0;
+    timer.previous      = InvalidIndex;
+    timer.next          = InvalidIndex;
+    timer.state         = State::Free;
+    mTimers.push_back(std::move(timer));
+    return static_cast<uint32_t>(mTimers.size() - 1);
+}
+
+inline
+auto TimerWheel::releaseTimer(const uint32_t index) -> void
+{
+    Timer& timer = mTimers[index];
+    timer.callback = Callback();
+    timer.state    = State::Free;
+    timer.previous = InvalidIndex;
+    timer.next     = mFreeList;
+    ++timer.generation; // invalidates outstanding TimerIds
+    mFreeList = index;
+    --mSize;
+}
+
+inline
+auto TimerWheel::link(const uint32_t index) -> void
+{
+    const size_t slot = static_cast<size_t>(mTimers[index].deadlineTick & (mSlots.size() - 1));
+
+    Timer& timer = mTimers[index];
+    timer.state    = State::Scheduled;
+    timer.previous = InvalidIndex;
+    timer.next     = mSlots[slot];
+
+    if (InvalidIndex != timer.next)
+    {
+        mTimers[timer.next].previous = index;
+    }
+
+    mSlots[slot] = index;
+    mOccupiedSlots[slot / BitsPerWord] |= (uint64_t(1) << (slot % BitsPerWord));
+}
+
+inline
+auto TimerWheel::unlink(const uint32_t index) -> void
+{
+    const size_t slot = static_cast<size_t>(mTimers[index].deadlineTick & (mSlots.size() - 1));
+
+    Timer& timer = mTimers[index];
+    if (InvalidIndex != timer.previous)
+    {
+        mTimers[timer.previous].next = timer.next;
+    }
+    else
+    {
+        mSlots[slot] = timer.next;
+    }
+
+    if (InvalidIndex != timer.next)
+    {
+        mTimers[timer.next].previous = timer.previous;
+    }
+
+    if (InvalidIndex == mSlots[slot])
+    {
+        mOccupiedSlots[slot / BitsPerWord] &= ~(uint64_t(1) << (slot % BitsPerWord));
+    }
+
+    timer.previous = InvalidIndex;
+    timer.next     = InvalidIndex;
+}
+
+inline
+auto TimerWheel::restoreCallback(const DueTimer& dueTimer, Callback&& callback) -> void
+{
+    // Only a periodic timer that is still scheduled keeps its callback; a
+    // one-shot timer has been released, which changed its generation.
+    Timer& timer = mTimers[dueTimer.index];
+    if (timer.generation == dueTimer.generation && State::Scheduled == timer.state)
+    {
+        timer.callback = std::move(callback);
+    }
+}
+
+inline
+auto TimerWheel::rescheduleDueTimers(const std::vector<DueTimer>& dueTimers, const size_t first) -> void
+{
+    for (size_t i = first; i < dueTimers.size(); ++i)
+    {
+        Timer& timer = mTimers[dueTimers[i].index];
+        if (timer.generation == dueTimers[i].generation && State::Due == timer.state)
+        {
+            // Overdue, so placed in the first slot the next advance visits.
+            timer.deadlineTick = mNextTick;
+            link(dueTimers[i].index);
+        }
+    }
+}
+
+inline
+auto TimerWheel::findNextOccupiedSlot(const size_t fromSlot) const -> size_t
+{
+    const size_t wordCount = mOccupiedSlots.size();
+    const size_t firstWord = fromSlot / BitsPerWord;
+
+    // The first word is visited twice: once for the slots at and after
+    // 'fromSlot', and once more after wrapping around for those before it.
+    for (size_t i = 0; i <= wordCount; ++i)
+    {
+        const size_t word = (firstWord + i) % wordCount;
+        uint64_t bits = mOccupiedSlots[word];
+        if (0 == i)
+        {
+            bits &= ~uint64_t(0) << (fromSlot % BitsPerWord);
+        }
+
+        if (0 != bits)
+        {
+            size_t bit = 0;
+            while (0 == (bits & (uint64_t(1) << bit)))
+            {
+                ++bit;
+            }
+
+            return (word * BitsPerWord + bit);
+        }
+    }
+
+    CPPEROMQ_ASSERT(false);
+    return fromSlot;
+}
+
+inline
+auto TimerWheel::getCurrentTick() const -> uint64_t
+{
+    return static_cast<uint64_t>((Clock::now() - mStartTime) / mResolution);
+}
+
+inline
+auto TimerWheel::toTicks(const std::chrono::milliseconds duration) const -> uint64_t
+{
+    if (duration.count() <= 0)
+    {
+        return 0;
+    }
+
+    // Round up so that a timer never fires early.
+    const Clock::duration clockDuration = std::chrono::duration_cast<Clock::duration>(duration);
+    return static_cast<uint64_t>((clockDuration + mResolution - Clock::duration(1)) / mResolution);
+}
+
+inline
+auto TimerWheel::makeTimerId(const uint32_t index, const uint32_t generation) -> TimerId
+{
+    return ((static_cast<TimerId>(generation) << 32) | index);
+}
+
+}